@@ -6,18 +6,15 @@
 #ifndef __LABTHINGS__H__
 #define __LABTHINGS__H__
 
-// define fast digital i/o to include (experimental) direct port writing
-//#define FAST_DIGITAL
-#ifdef FAST_DIGITAL
-#include "utilities/fast_digital.h"
-#endif
-
  #if defined(ARDUINO) && ARDUINO >= 100
 #include "Arduino.h"
 #else
 #include "WProgram.h"
 #endif
 
+// direct port i/o for pins known at compile time: FastPin<N>
+#include "utilities/fast_pin.h"
+
 //macro to allow debugging via Serial1 to be switched on or off
 //comment out DEBUG_PRINT to turn off
 //#define DEBUG_PRINT
@@ -41,14 +38,18 @@ const static float LT_VERSION = 0.20;
 #include "devices/device.h"
 #include "devices/sensor.h"
 #include "devices/analog_output.h"
+#include "devices/ramped_output.h"
 #include "devices/analog_sensor.h"
 #include "devices/debounced_button.h"
 #include "devices/device_manager.h"
 #include "devices/digital_output.h"
+#include "devices/output_group.h"
 #include "devices/digital_sensor.h"
 #include "devices/encoder.h"
 #include "devices/stepper.h"
+#include "devices/motion_group.h"
 #include "devices/buzzer.h"
+#include "devices/soft_pwm.h"
 
 //requires U8G2
 #include "ui/ui.h"
@@ -63,12 +64,16 @@ const static float LT_VERSION = 0.20;
 #include "messengers/commands.h"
 #include "messengers/ascii_serial.h"
 #include "messengers/binary_serial.h"
+#include "messengers/schema.h"
+#include "messengers/reliable_link.h"
 #include "messengers/message_handler.h"
 #include "messengers/process_manager.h"
 
 #include "utilities/noise_maker.h"
 #include "utilities/streaming.h"
 #include "utilities/timer.h"
+#include "utilities/timer_service.h"
+#include "utilities/event_bus.h"
 
 template <typename T>
 T safeMap(T x, T in_min, T in_max, T out_min, T out_max)
@@ -21,7 +21,7 @@ class LT_AnalogOutput : public LT_DigitalOutput {
     virtual LT::DeviceType type() const { return LT::AnalogOutput; }
     
     void begin() {
-      ledcAttachPin(_pin, m_channel);
+      ledcAttachPin(_pin.number(), m_channel);
       ledcSetup(m_channel, 12000, 8); // 12 kHz PWM, 8-bit resolution
     }
     
@@ -40,7 +40,7 @@ class LT_AnalogOutput : public LT_DigitalOutput {
     
     void setValue(const int value) {
       _value = value;
-      analogWrite(_pin, _value);
+      analogWrite(_pin.number(), _value);
     }
     LT_AnalogOutput* instance(){ return this; }
 };
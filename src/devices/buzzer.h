@@ -34,7 +34,7 @@ public:
           #if defined(ARDUINO_ARCH_ESP32)
           ledcWriteTone(m_channel, 0);
           #else
-          noTone(_pin);
+          noTone(_pin.number());
           #endif
           m_is_noisy = false;
           m_last_update = now;
@@ -51,7 +51,7 @@ public:
           #if defined(ARDUINO_ARCH_ESP32)
           ledcWriteTone(m_channel, m_frequency);
           #else
-          tone(_pin, m_frequency);
+          tone(_pin.number(), m_frequency);
           #endif
           m_is_noisy = true;
           m_last_update = now;
@@ -69,7 +69,7 @@ public:
         #if defined(ARDUINO_ARCH_ESP32)
           ledcWriteTone(m_channel, 0);
           #else
-          noTone(_pin);
+          noTone(_pin.number());
           #endif
           m_is_noisy = false;
       }
@@ -2,19 +2,25 @@
 #define __DEBOUNCED_BUTTON_H__
 
 #include "device.h"
+#include "../utilities/fast_pin.h"
+#include "../utilities/delegate.h"
 
 typedef void(*voidCallback) ();
 
-class LT_DebouncedButton : public LT_Device {
-    const uint8_t _pin;
+/*!
+ * @tparam PIN the pin type of the button input, LT_Pin or FastPin<N>
+ */
+template <class PIN = LT_Pin>
+class LT_BasicDebouncedButton : public LT_Device {
+    const PIN _pin;
     const uint8_t _pullup_enable;
     volatile uint8_t _button_state;
     volatile uint8_t _last_button_state;
     volatile uint32_t _t_last_state_change_us;
     volatile bool _button_went_low, _button_went_high;
     uint32_t _debounce_interval_us = 50000;//50ms
-    voidCallback _callback_released = nullptr;
-    voidCallback _callback_pressed = nullptr;
+    LT::Delegate<void()> _callback_released;
+    LT::Delegate<void()> _callback_pressed;
     
     inline void onButtonStateChanged() {
       if (_button_state == HIGH) {
@@ -26,15 +32,15 @@ class LT_DebouncedButton : public LT_Device {
     }
 
   public:
-    LT_DebouncedButton(const uint8_t id, const uint8_t pin, const uint8_t pullup_enable = false)
+    LT_BasicDebouncedButton(const uint8_t id, const PIN pin = PIN(), const uint8_t pullup_enable = false)
     : LT_Device(id), _pin(pin), _pullup_enable(pullup_enable) {}
     
     virtual LT::DeviceType type() const { return LT::DebouncedButton; }
     
-    void setButtonReleasedCallback(voidCallback c) {
+    void setButtonReleasedCallback(LT::Delegate<void()> c) {
       _callback_released = c;
     }
-    void setButtonPressedCallback(voidCallback c) {
+    void setButtonPressedCallback(LT::Delegate<void()> c) {
       _callback_pressed = c;
     }
     void setDebounceInterval(uint32_t interval) {
@@ -47,12 +53,12 @@ class LT_DebouncedButton : public LT_Device {
 
     void begin() {
         if(_pullup_enable){
-            pinMode(_pin, INPUT_PULLUP);
+            _pin.mode(INPUT_PULLUP);
         }
         else {
-            pinMode(_pin, INPUT);
+            _pin.mode(INPUT);
         }
-      _last_button_state = _button_state = digitalRead(_pin);
+      _last_button_state = _button_state = _pin.read();
       _t_last_state_change_us = LT_current_time_us;
       _button_went_low = _button_went_high = false;
     }
@@ -78,13 +84,13 @@ class LT_DebouncedButton : public LT_Device {
       debounceLockout();
       if (_button_went_high) {
         if (_callback_released != nullptr) {
-          (*_callback_released)();
+          _callback_released();
         }
         _button_went_high = false;
       }
       else if (_button_went_low) {
         if (_callback_pressed != nullptr) {
-           (*_callback_pressed)();
+           _callback_pressed();
          }
          _button_went_low = false;
        }
@@ -99,7 +105,7 @@ class LT_DebouncedButton : public LT_Device {
      */
     /**************************************************************************/
     inline void debounceLockout() {
-      uint8_t reading = digitalRead(_pin);
+      uint8_t reading = _pin.read();
       if ( ( LT_current_time_us - _t_last_state_change_us ) >= _debounce_interval_us ) {
         // if the debounce interval has elapsed, save the button state
         if ( reading != _button_state ) {
@@ -120,7 +126,7 @@ class LT_DebouncedButton : public LT_Device {
      */
     /**************************************************************************/
     inline void debounceSteady() {
-      uint8_t reading = digitalRead(_pin);
+      uint8_t reading = _pin.read();
 
       // if the state has changed, note the time
       if (reading != _last_button_state) {
@@ -140,4 +146,6 @@ class LT_DebouncedButton : public LT_Device {
     
 };
 
+typedef LT_BasicDebouncedButton<> LT_DebouncedButton;
+
 #endif // End __DEBOUNCED_BUTTON_H__ include guard
@@ -2,19 +2,24 @@
 #define __DIGITAL_OUTPUT_H__
 
 #include "device.h"
+#include "../utilities/fast_pin.h"
 
-class LT_DigitalOutput : public LT_Device {
+/*!
+ * @tparam PIN the pin type of the output, LT_Pin or FastPin<N>
+ */
+template <class PIN = LT_Pin>
+class LT_BasicDigitalOutput : public LT_Device {
   protected:
-    const uint8_t _pin;
+    const PIN _pin;
     uint8_t _value;
 
   public:
-    LT_DigitalOutput(const uint8_t id, const uint8_t pin) : LT_Device(id), _pin(pin) {}
+    LT_BasicDigitalOutput(const uint8_t id, const PIN pin = PIN()) : LT_Device(id), _pin(pin) {}
     
     virtual LT::DeviceType type() const { return LT::DigitalOutput; }
     
     void begin() {
-      pinMode(_pin, OUTPUT);
+      _pin.mode(OUTPUT);
     }
     
     uint8_t getValue() {
@@ -23,10 +28,12 @@ class LT_DigitalOutput : public LT_Device {
     
     void setValue(uint8_t value) {
       _value = value;
-      digitalWrite(_pin,_value);
+      _pin.write(_value);
     }
     
-    LT_DigitalOutput* instance() {return this;}
+    LT_BasicDigitalOutput* instance() {return this;}
 };
 
+typedef LT_BasicDigitalOutput<> LT_DigitalOutput;
+
 #endif // End __DIGITAL_OUTPUT_H__ include guard
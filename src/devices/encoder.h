@@ -2,6 +2,7 @@
 #define __ENCODER_H__
 
 #include "device.h"
+#include "../utilities/delegate.h"
 
 class LT_Encoder : public LT_Device {
     const uint8_t _pin_a; //< local copy of pin a of the encoder
@@ -12,7 +13,7 @@ class LT_Encoder : public LT_Device {
     volatile uint32_t _t_last_state_change_us = 0;
     //volatile uint32_t _t_last_check_us = 0;
     uint32_t _debounce_interval_us = 100000; //< encoder ignores events within this interval (default = 100ms)
-    Callback _value_changed_callback = nullptr;
+    LT::Delegate<void()> _value_changed_callback;
     
     volatile uint8_t _old_AB = 0; // use for 16-state
 
@@ -31,7 +32,7 @@ class LT_Encoder : public LT_Device {
       
     virtual LT::DeviceType type() const { return LT::Encoder; }
       
-    void setValueChangedCallback(Callback c) {
+    void setValueChangedCallback(LT::Delegate<void()> c) {
       _value_changed_callback = c;
     }
     
@@ -90,7 +91,7 @@ class LT_Encoder : public LT_Device {
 */
       if(_position != _last_position) {
         if(_value_changed_callback != nullptr) {
-          (*_value_changed_callback)();
+          _value_changed_callback();
         }
         _last_position = _position;
       }
@@ -0,0 +1,402 @@
+#ifndef __MOTION_GROUP_H__
+#define __MOTION_GROUP_H__
+
+#include "device.h"
+#include "stepper.h"
+#include "../utilities/ring_buffer.h"
+
+/*!
+ * @file motion_group.h
+ *
+ * LT_MotionGroup drives several LT_Stepper devices from a single step tick
+ * so that straight line moves start and finish on every axis at the same time.
+ * Steps are distributed between axes with Bresenham (DDA) interpolation:
+ * the axis with the most steps (the major axis) steps on every tick and the
+ * other axes step when their error term overflows.
+ *
+ * Moves are placed in a short lookahead queue. The next segment is loaded
+ * (and the direction pins are set) on the falling edge of the last pulse of
+ * the previous segment, so consecutive moves run back to back without stopping.
+ *
+ * With setAcceleration(), the tick rate ramps up and down with a trapezoidal
+ * profile, and the queue is planned so that moves blend at the junctions.
+ * The rate at a junction is at most the lower rate of the two moves, times
+ * the cosine of the angle between them: moves in the same direction keep
+ * their speed, a right angle or reversal slows to a stop, and angles in
+ * between slow down in proportion. Each time a move is queued, the exit rate
+ * of every waiting move (and of the move that is running) is set to the
+ * highest rate that still lets the rest of the queue slow down to a stop at
+ * its end. Rates and accelerations are those of the major axis, in ticks.
+ * The ramp takes one float division per tick, about 40 us on a 16 MHz AVR.
+ *
+ * The group can be ticked from update() or from LT_StepTimer with
+ * LT_STEP_TIMER_ISR(group) and setInterruptDriven(true).
+ * Steppers in a group should not be commanded with rotate() or setSpeed().
+ * Groups of steppers with FastPin pins set the STEPPER template parameter,
+ * for example LT_MotionGroup<2, 4, LT_BasicStepper< FastPin<2>, FastPin<5> > >
+ */
+
+/*!
+ * @brief one straight line move of all axes in a motion group
+ */
+template <uint8_t N_AXES>
+struct MotionSegment {
+  int32_t steps[N_AXES]; ///< signed number of steps to take on each axis
+  uint32_t interval; ///< time in microseconds between steps of the major axis
+  uint32_t ticks; ///< the number of steps of the major axis
+  float entry_step; ///< the highest rate at the junction with the previous move, as the ramp step at that rate
+  float exit_step; ///< the planned rate at the end of the move, as the ramp step at that rate
+};
+
+template <uint8_t N_AXES, uint8_t QUEUE_LENGTH = 4, class STEPPER = LT_Stepper>
+class LT_MotionGroup : public LT_Device {
+    STEPPER* _axes[N_AXES] = {nullptr}; ///< the steppers that make up the group
+    RingBuffer<QUEUE_LENGTH, MotionSegment<N_AXES> > _queue; ///< lookahead queue of moves
+    MotionSegment<N_AXES> _current = {}; ///< the move that is being run
+    uint32_t _delta[N_AXES]; ///< the absolute number of steps for each axis in the current move
+    int32_t _error[N_AXES]; ///< Bresenham error term for each axis
+    uint32_t _major = 0; ///< the number of ticks in the current move
+    uint32_t _ticks_remaining = 0; ///< the number of ticks left in the current move
+    uint32_t _t_last_tick = 0; ///< the system time in microseconds of the last tick
+    uint32_t _pulse_width = 30; ///< the minimum time in microseconds to hold a step pulse high
+    uint32_t _interval = 0; ///< the time in microseconds from the last tick to the next
+    float _acceleration = 0; ///< the acceleration of the major axis in ticks/s^2. 0 changes rate immediately
+    float _first_interval = 0; ///< the interval to the first tick from rest at the acceleration
+    float _ramp_interval = 0; ///< the interval while ramping
+    float _ramp_step = 0; ///< the number of ticks it would take to reach the ramp rate from rest
+    volatile uint8_t _pulse_mask = 0; ///< bit i is set while axis i has a step pulse high
+    volatile bool _active = false; ///< true while a move is loaded
+    bool _interrupt_driven = false;
+
+    // take the next move from the queue and set the direction pins.
+    // moves with no steps are skipped.
+    bool loadSegment() {
+      while( _queue.takeBack(&_current) == 0 ) {
+        _major = 0;
+        for( uint8_t i = 0; i < N_AXES; ++i ) {
+          const bool forward = ( _current.steps[i] >= 0 );
+          _delta[i] = forward ? _current.steps[i] : -_current.steps[i];
+          if( _delta[i] > _major ) {
+            _major = _delta[i];
+          }
+          if( _delta[i] > 0 ) {
+            _axes[i]->setDirection(forward);
+          }
+        }
+        if( _major > 0 ) {
+          for( uint8_t i = 0; i < N_AXES; ++i ) {
+            _error[i] = _major >> 1;
+          }
+          _ticks_remaining = _major;
+          _active = true;
+          return true;
+        }
+      }
+      _active = false;
+      return false;
+    }
+
+    // start a step pulse on every axis whose error term overflows
+    void tick() {
+      uint8_t mask = 0;
+      for( uint8_t i = 0; i < N_AXES; ++i ) {
+        _error[i] -= _delta[i];
+        if( _error[i] < 0 ) {
+          _error[i] += _major;
+          _axes[i]->beginPulse();
+          mask |= (1 << i);
+        }
+      }
+      _ticks_remaining--;
+      _pulse_mask = mask;
+    }
+
+    // end the step pulses and load the next move when this one is done
+    void endPulses() {
+      const uint8_t mask = _pulse_mask;
+      for( uint8_t i = 0; i < N_AXES; ++i ) {
+        if( mask & (1 << i) ) {
+          _axes[i]->endPulse();
+        }
+      }
+      _pulse_mask = 0;
+      if( _ticks_remaining == 0 ) {
+        loadSegment();
+      }
+      if( _active ) {
+        _interval = nextInterval();
+      }
+    }
+
+    // set the interval to the first tick of a move started from rest
+    void beginRamp() {
+      _ramp_step = 0;
+      _ramp_interval = _first_interval;
+      if( _acceleration <= 0 || _ramp_interval < _current.interval ) {
+        _ramp_interval = _current.interval;
+      }
+      _interval = _ramp_interval;
+    }
+
+    // advance the ramp by one tick and return the interval to the next tick.
+    // Slows down when the ticks left are only enough to reach the exit
+    // rate, else speeds up towards the rate of the move
+    // (Austin, "Generate stepper-motor speed profiles in real time")
+    uint32_t nextInterval() {
+      if( _acceleration <= 0 ) {
+        return _current.interval;
+      }
+      const bool brake = ( _ramp_step - _current.exit_step >= _ticks_remaining );
+      if( !brake && _ramp_interval > _current.interval ) {
+        _ramp_step++;
+        _ramp_interval -= 2.0 * _ramp_interval / (4.0 * _ramp_step + 1.0);
+        if( _ramp_interval < _current.interval ) {
+          _ramp_interval = _current.interval;
+        }
+      }
+      else if( brake || _ramp_interval < _current.interval ) {
+        if( _ramp_step > 1 ) {
+          _ramp_interval += 2.0 * _ramp_interval / (4.0 * _ramp_step - 1.0);
+          _ramp_step--;
+        }
+        else {
+          _ramp_step = 0;
+          _ramp_interval = (_first_interval > _current.interval) ? _first_interval : _current.interval;
+        }
+        if( !brake && _ramp_interval > _current.interval ) {
+          _ramp_interval = _current.interval;
+        }
+      }
+      return _ramp_interval;
+    }
+
+    // the highest rate at the junction of two moves, as a ramp step
+    float junctionStep(const MotionSegment<N_AXES> &from, const MotionSegment<N_AXES> &to) const {
+      float dot = 0, from_sq = 0, to_sq = 0;
+      for( uint8_t i = 0; i < N_AXES; ++i ) {
+        dot += (float)from.steps[i] * to.steps[i];
+        from_sq += (float)from.steps[i] * from.steps[i];
+        to_sq += (float)to.steps[i] * to.steps[i];
+      }
+      if( dot <= 0 ) {
+        return 0;
+      }
+      const float cosine = dot / sqrt(from_sq * to_sq);
+      const float rate = cosine * 1000000.0 / ( (from.interval > to.interval) ? from.interval : to.interval );
+      return rate * rate / (2.0 * _acceleration);
+    }
+
+    // set the exit rate of each queued move, newest first, so that every
+    // move can slow down to the entry rate of the next and the last move
+    // ends at rest. Called with interrupts locked
+    void plan() {
+      float limit = 0;
+      for( uint8_t i = _queue.count(); i > 0; --i ) {
+        MotionSegment<N_AXES> segment;
+        if( _queue.get(i - 1, &segment) != 0 ) {
+          break;
+        }
+        segment.exit_step = limit;
+        _queue.replace(segment, i - 1);
+        limit = limit + segment.ticks;
+        if( segment.entry_step < limit ) {
+          limit = segment.entry_step;
+        }
+      }
+      _current.exit_step = limit;
+    }
+
+    void lock() {
+      if( _interrupt_driven ) noInterrupts();
+    }
+
+    void unlock() {
+      if( _interrupt_driven ) interrupts();
+    }
+
+  public:
+    LT_MotionGroup(const uint8_t id) : LT_Device(id) {
+      static_assert(N_AXES <= 8, "A motion group can have at most 8 axes");
+    }
+
+    LT::DeviceType type() const { return LT::UserType; }
+
+    LT_MotionGroup* instance() { return this; }
+
+    /*!
+     * @brief assign a stepper to an axis of the group. All axes must
+     * be assigned before a move is queued.
+     *
+     * @param axis the index of the axis [0, N_AXES)
+     * @param stepper the stepper motor that drives the axis
+     */
+    void setAxis(const uint8_t axis, STEPPER* stepper) {
+      if( axis < N_AXES ) {
+        _axes[axis] = stepper;
+      }
+    }
+
+    /*!
+     * @brief Set the time to hold step pins high. Use the longest
+     * minimum pulse width of the drivers in the group.
+     */
+    void setPulseWidth(const uint32_t pulse_width) {
+      _pulse_width = pulse_width;
+    }
+
+    /*!
+     * @brief Set the acceleration of the tick rate, which ramps moves up to
+     * speed and blends them at the junctions. Set before queueing moves.
+     *
+     * @param acceleration in steps/s^2 of the axis with the most steps.
+     * 0 (the default) runs every move at its rate from the first tick
+     */
+    void setAcceleration(const float acceleration) {
+      _acceleration = (acceleration > 0) ? acceleration : 0;
+      if( _acceleration > 0 ) {
+        _first_interval = 676000.0 * sqrt(2.0 / _acceleration);
+      }
+    }
+
+    /*!
+     * @brief Generate ticks from the LT_StepTimer interrupt instead of update().
+     * The sketch must connect the timer with LT_STEP_TIMER_ISR(group).
+     *
+     * @param enabled true to use the step timer
+     * @return true if the step timer is used, false if this board has no
+     * timer backend and update() still generates the ticks
+     */
+    bool setInterruptDriven(const bool enabled) {
+      if( enabled ) {
+        if( !LT_StepTimer::available() ) {
+          return false;
+        }
+        LT_StepTimer::begin();
+      }
+      else {
+        LT_StepTimer::stop();
+        _t_last_tick = LT_current_time_us;
+      }
+      _interrupt_driven = enabled;
+      return enabled;
+    }
+
+    /*!
+     * @brief add a straight line move to the queue
+     *
+     * @param steps the signed number of steps for each axis
+     * @param rate the step rate of the axis with the most steps in steps/s
+     * @return true if there was room in the queue
+     */
+    bool queueMove(const int32_t steps[N_AXES], const float rate) {
+      if( rate <= 0 ) return false;
+      MotionSegment<N_AXES> segment = {};
+      for( uint8_t i = 0; i < N_AXES; ++i ) {
+        segment.steps[i] = steps[i];
+        const uint32_t delta = (steps[i] >= 0) ? steps[i] : -steps[i];
+        if( delta > segment.ticks ) {
+          segment.ticks = delta;
+        }
+      }
+      segment.interval = 1000000.0 / rate;
+      if( segment.interval < 2 * _pulse_width ) {
+        segment.interval = 2 * _pulse_width;
+      }
+
+      // the move before this one, if the group will not stop in between
+      MotionSegment<N_AXES> previous = {};
+      lock();
+      bool blend = ( _queue.first(&previous) == 0 );
+      if( !blend && _active ) {
+        previous = _current;
+        blend = true;
+      }
+      unlock();
+      if( blend && _acceleration > 0 ) {
+        segment.entry_step = junctionStep(previous, segment);
+      }
+
+      lock();
+      const bool queued = ( _queue.put(segment) == 0 );
+      if( queued && _acceleration > 0 ) {
+        plan();
+      }
+      unlock();
+      return queued;
+    }
+
+    /*!
+     * @brief stop all axes and discard queued moves. A pulse that is
+     * already high is finished.
+     */
+    void stop() {
+      lock();
+      _queue.reset();
+      _ticks_remaining = 0;
+      _active = false;
+      unlock();
+    }
+
+    /*!
+     * @return the number of moves that can still be queued
+     */
+    uint8_t available() const { return _queue.size() - _queue.count(); }
+
+    /*!
+     * @return true while a move is running
+     */
+    bool isMoving() const { return _active; }
+
+    void update() {
+      if( _interrupt_driven ) {
+        if( !_active && !LT_StepTimer::isActive() ) {
+          lock();
+          const bool loaded = loadSegment();
+          unlock();
+          if( loaded ) {
+            beginRamp();
+            LT_StepTimer::start(_interval);
+          }
+        }
+        return;
+      }
+      if( _pulse_mask ) {
+        if( (LT_current_time_us - _t_last_tick) >= _pulse_width ) {
+          endPulses();
+        }
+      }
+      else if( _active ) {
+        if( (LT_current_time_us - _t_last_tick) >= _interval ) {
+          _t_last_tick += _interval;
+          tick();
+        }
+      }
+      else if( loadSegment() ) {
+        beginRamp();
+        _t_last_tick = LT_current_time_us;
+      }
+    }
+
+    /*!
+     * @brief Called from the step timer interrupt for each pulse edge.
+     *
+     * @return uint32_t the time in microseconds until the next edge,
+     * or 0 if there are no more moves.
+     */
+    LT_ISR_ATTR uint32_t onStepTimer() {
+      if( _pulse_mask ) {
+        endPulses();
+        if( !_active ) {
+          return 0;
+        }
+        return (_interval > 2 * _pulse_width) ? (_interval - _pulse_width) : _pulse_width;
+      }
+      if( !_active ) {
+        return 0;
+      }
+      tick();
+      return _pulse_width;
+    }
+};
+
+#endif //End __MOTION_GROUP_H__ include guard
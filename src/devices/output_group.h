@@ -0,0 +1,258 @@
+#ifndef __OUTPUT_GROUP_H__
+#define __OUTPUT_GROUP_H__
+
+#include "device.h"
+#include "../utilities/ring_buffer.h"
+
+/*!
+ * @file output_group.h
+ *
+ * LT_OutputGroup drives several digital outputs, such as the valves of a
+ * manifold, as one device. Channel i of the group is bit i of a pattern.
+ * setPattern() sorts the channels by port and writes each port once with
+ * interrupts disabled, so every output in the group changes together.
+ *
+ * AVR: one read-modify-write of each PORTx register
+ * ESP32: one write each to the GPIO set and clear registers (pins 0-31 only)
+ * Other platforms: digitalWrite() on each channel with interrupts disabled
+ *
+ * A short sequence of patterns, each with a hold time, can be queued with
+ * queuePattern() and played back from update().
+ */
+
+#ifndef LT_OUTPUT_SEQUENCE_LENGTH
+#define LT_OUTPUT_SEQUENCE_LENGTH 8
+#endif
+
+/*!
+ * @brief one step of an output group sequence
+ */
+struct OutputPattern {
+  uint32_t pattern; ///< bit i is the state of channel i
+  uint32_t duration; ///< time in microseconds to hold the pattern
+};
+
+/*!
+ * @tparam N_CHANNELS the number of outputs in the group (at most 32)
+ * @tparam SEQUENCE_LENGTH the number of patterns that can be queued (a power of 2)
+ */
+template <uint8_t N_CHANNELS, uint8_t SEQUENCE_LENGTH = LT_OUTPUT_SEQUENCE_LENGTH>
+class LT_OutputGroup : public LT_Device {
+#if defined(__AVR__)
+    volatile uint8_t* _port_out[N_CHANNELS]; ///< the PORTx register of each port used by the group
+    uint8_t _port_count = 0; ///< the number of different ports used by the group
+    uint8_t _channel_port[N_CHANNELS]; ///< the index in _port_out of each channel
+    uint8_t _channel_mask[N_CHANNELS]; ///< the port bit mask of each channel
+#endif
+    int8_t _pins[N_CHANNELS]; ///< the pin number of each channel, -1 if unassigned
+    uint32_t _pattern = 0; ///< the last pattern written to the outputs
+    RingBuffer<SEQUENCE_LENGTH, OutputPattern> _sequence; ///< queued patterns
+    uint8_t _step = 0; ///< index of the sequence step that is being held
+    uint16_t _repeats = 0; ///< the number of times left to play the sequence, 0 plays it forever
+    uint32_t _t_step = 0; ///< the system time in microseconds that the current step started
+    bool _running = false;
+
+    // write the channels selected by mask. Bits past N_CHANNELS are ignored
+    void write(const uint32_t pattern, const uint32_t mask) {
+#if defined(__AVR__)
+      uint8_t set[N_CHANNELS] = {0};
+      uint8_t clear[N_CHANNELS] = {0};
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        if( _pins[i] < 0 || !(mask & (1UL << i)) ) continue;
+        if( pattern & (1UL << i) ) {
+          set[_channel_port[i]] |= _channel_mask[i];
+        }
+        else {
+          clear[_channel_port[i]] |= _channel_mask[i];
+        }
+      }
+      const uint8_t sreg = SREG;
+      cli();
+      for( uint8_t p = 0; p < _port_count; ++p ) {
+        if( set[p] | clear[p] ) {
+          *_port_out[p] = (*_port_out[p] & ~clear[p]) | set[p];
+        }
+      }
+      SREG = sreg;
+#elif defined(ARDUINO_ARCH_ESP32)
+      uint32_t set = 0;
+      uint32_t clear = 0;
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        if( _pins[i] < 0 || !(mask & (1UL << i)) ) continue;
+        if( pattern & (1UL << i) ) {
+          set |= (1UL << _pins[i]);
+        }
+        else {
+          clear |= (1UL << _pins[i]);
+        }
+      }
+      // the set and clear registers do not need a read-modify-write,
+      // interrupts are only held off between the two writes
+      noInterrupts();
+      if( set ) REG_WRITE(GPIO_OUT_W1TS_REG, set);
+      if( clear ) REG_WRITE(GPIO_OUT_W1TC_REG, clear);
+      interrupts();
+#else
+      noInterrupts();
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        if( _pins[i] < 0 || !(mask & (1UL << i)) ) continue;
+        digitalWrite(_pins[i], (pattern & (1UL << i)) ? HIGH : LOW);
+      }
+      interrupts();
+#endif
+      _pattern = (_pattern & ~mask) | (pattern & mask);
+    }
+
+    // write the pattern of the current sequence step
+    bool loadStep() {
+      OutputPattern p = {};
+      if( _sequence.get(_step, &p) != 0 ) {
+        return false;
+      }
+      write(p.pattern, 0xFFFFFFFFUL);
+      return true;
+    }
+
+  public:
+    LT_OutputGroup(const uint8_t id) : LT_Device(id) {
+      static_assert(N_CHANNELS > 0 && N_CHANNELS <= 32, "An output group can have 1 to 32 channels");
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        _pins[i] = -1;
+      }
+    }
+
+    LT::DeviceType type() const { return LT::UserType; }
+
+    LT_OutputGroup* instance() { return this; }
+
+    /*!
+     * @brief assign a pin to a channel of the group. The pin is set to an
+     * output and driven to the current state of the channel.
+     *
+     * @param channel the index of the channel [0, N_CHANNELS)
+     * @param pin the digital pin number
+     * @return int8_t 0 on success, -1 if the channel or pin is not valid
+     */
+    int8_t setChannel(const uint8_t channel, const uint8_t pin) {
+      if( channel >= N_CHANNELS ) return -1;
+#if defined(__AVR__)
+      const uint8_t port = digitalPinToPort(pin);
+      if( port == NOT_A_PIN ) return -1;
+      volatile uint8_t* out = portOutputRegister(port);
+      uint8_t p = 0;
+      while( p < _port_count && _port_out[p] != out ) {
+        ++p;
+      }
+      if( p == _port_count ) {
+        _port_out[_port_count++] = out;
+      }
+      _channel_port[channel] = p;
+      _channel_mask[channel] = digitalPinToBitMask(pin);
+#elif defined(ARDUINO_ARCH_ESP32)
+      if( pin >= 32 ) return -1;
+#endif
+      _pins[channel] = pin;
+      pinMode(pin, OUTPUT);
+      write(_pattern, 1UL << channel);
+      return 0;
+    }
+
+    /*!
+     * @brief write the outputs of the group at the same time
+     *
+     * @param pattern bit i is the new state of channel i
+     * @param mask only channels with their bit set in mask are written.
+     * The default writes every channel
+     */
+    void setPattern(const uint32_t pattern, const uint32_t mask = 0xFFFFFFFFUL) {
+      write(pattern, mask);
+    }
+
+    /*!
+     * @return uint32_t the last pattern written to the outputs
+     */
+    uint32_t getPattern() const { return _pattern; }
+
+    /*!
+     * @brief write a single channel
+     */
+    void setValue(const uint8_t channel, const uint8_t value) {
+      if( channel < N_CHANNELS ) {
+        write(value ? (1UL << channel) : 0, 1UL << channel);
+      }
+    }
+
+    uint8_t getValue(const uint8_t channel) const {
+      return (_pattern >> channel) & 1;
+    }
+
+    /*!
+     * @brief add a step to the end of the pattern sequence
+     *
+     * @param pattern bit i is the state of channel i during the step
+     * @param duration the time in microseconds to hold the pattern
+     * @return true if there was room in the sequence
+     */
+    bool queuePattern(const uint32_t pattern, const uint32_t duration) {
+      OutputPattern p = {pattern, duration};
+      return ( _sequence.put(p) == 0 );
+    }
+
+    /*!
+     * @brief write the first queued pattern and start playing the sequence
+     *
+     * @param repeats the number of times to play the sequence. 0 repeats it until stopped
+     * @return true if the sequence has at least one step
+     */
+    bool startSequence(const uint16_t repeats = 1) {
+      _step = 0;
+      _repeats = repeats;
+      _t_step = LT_current_time_us;
+      _running = loadStep();
+      return _running;
+    }
+
+    /*!
+     * @brief stop the sequence. The outputs keep the current pattern
+     */
+    void stopSequence() { _running = false; }
+
+    /*!
+     * @brief stop the sequence and remove all queued patterns
+     */
+    void clearSequence() {
+      _running = false;
+      _sequence.reset();
+    }
+
+    bool isRunning() const { return _running; }
+
+    /*!
+     * @return the number of patterns in the sequence
+     */
+    uint8_t sequenceLength() const { return _sequence.count(); }
+
+    /*!
+     * @return the number of patterns that can still be queued
+     */
+    uint8_t available() const { return _sequence.size() - _sequence.count(); }
+
+    void update() {
+      if( !_running ) return;
+      OutputPattern p = {};
+      _sequence.get(_step, &p);
+      if( (LT_current_time_us - _t_step) < p.duration ) return;
+      // measure from the scheduled end of the step so hold times do not drift
+      _t_step += p.duration;
+      if( ++_step >= _sequence.count() ) {
+        _step = 0;
+        if( _repeats > 0 && --_repeats == 0 ) {
+          _running = false;
+          return;
+        }
+      }
+      loadStep();
+    }
+};
+
+#endif //End __OUTPUT_GROUP_H__ include guard
@@ -0,0 +1,191 @@
+#ifndef __RAMPED_OUTPUT_H__
+#define __RAMPED_OUTPUT_H__
+
+#include "analog_output.h"
+
+/*!
+ * @file ramped_output.h
+ *
+ * LT_RampedOutput is an analog output that moves toward its target instead
+ * of jumping to it, to avoid current spikes in heaters and pressure spikes
+ * when a valve is opened. A target can be reached at a fixed rate
+ * (setRate() and setTarget()) or along a linear or exponential profile over
+ * a set time (rampTo()).
+ *
+ * The output is advanced from update() with LT_current_time_us. Only
+ * integer math is used, and the output is written only when its value
+ * changes. A linear ramp computes its value from the time since it
+ * started, so it follows the line exactly and arrives at the end of the
+ * duration.
+ */
+
+namespace LT {
+  enum RampProfile : uint8_t {
+    Ramp_None = 0, ///< not ramping, the output is at its target
+    Ramp_Rate = 1, ///< move at a fixed rate in units per second
+    Ramp_Linear = 2, ///< move linearly, arriving at the end of the duration
+    Ramp_Exponential = 3 ///< approach the target with a time constant of 1/5 of the duration
+  };
+}
+
+class LT_RampedOutput : public LT_AnalogOutput {
+    // exponential ramps take 16 ticks per time constant and
+    // run for 5 time constants (~99%) before snapping to the target
+    static const uint8_t EXP_SHIFT = 4;
+    static const uint8_t EXP_TICKS = 5 << EXP_SHIFT;
+
+    int32_t _current = 0; ///< the value written to the output
+    int32_t _target = 0; ///< the value that the output is moving to
+    int32_t _start = 0; ///< the value that a linear ramp started from
+    int32_t _fixed = 0; ///< the exponential ramp value with 8 fractional bits
+    uint32_t _rate = 0; ///< the maximum rate of change in units per second. 0 is unlimited
+    uint32_t _step_us = 0; ///< the time in microseconds between steps (rate) or ticks (exponential)
+    uint32_t _t_step = 0; ///< the system time in microseconds of the last step or tick
+    uint32_t _t_start = 0; ///< the system time in microseconds that a timed ramp started
+    uint32_t _duration = 0; ///< the length of a timed ramp in microseconds
+    LT::RampProfile _profile = LT::Ramp_None;
+
+    void write(const int32_t value) {
+      if( value != _current ) {
+        _current = value;
+        LT_AnalogOutput::setValue(_current);
+      }
+    }
+
+    void finish() {
+      write(_target);
+      _profile = LT::Ramp_None;
+    }
+
+    // move up to steps units toward the target
+    void stepToward(const uint32_t steps) {
+      const int32_t diff = _target - _current;
+      if( (uint32_t)(diff >= 0 ? diff : -diff) <= steps ) {
+        finish();
+      }
+      else {
+        write(diff > 0 ? _current + (int32_t)steps : _current - (int32_t)steps);
+      }
+    }
+
+  public:
+#if defined(ARDUINO_ARCH_ESP32)
+    LT_RampedOutput(const uint8_t id, const uint8_t pin, const uint8_t channel)
+    : LT_AnalogOutput(id, pin, channel) {}
+#else
+    LT_RampedOutput(const uint8_t id, const uint8_t pin)
+    : LT_AnalogOutput(id, pin) {}
+#endif
+
+    /*!
+     * @brief set the output immediately and cancel any ramp
+     */
+    void setValue(const int value) {
+      _profile = LT::Ramp_None;
+      _target = value;
+      _current = value;
+      LT_AnalogOutput::setValue(value);
+    }
+
+    /*!
+     * @brief Set the maximum rate of change used by setTarget()
+     *
+     * @param units_per_s the rate in output units per second. 0 jumps to the target
+     */
+    void setRate(const uint32_t units_per_s) {
+      _rate = units_per_s;
+    }
+
+    uint32_t getRate() const { return _rate; }
+
+    /*!
+     * @brief move the output to a target at the rate set by setRate()
+     */
+    void setTarget(const int value) {
+      _target = value;
+      if( _rate == 0 ) {
+        finish();
+        return;
+      }
+      _step_us = (_rate >= 1000000UL) ? 1 : (1000000UL / _rate);
+      _t_step = LT_current_time_us;
+      _profile = LT::Ramp_Rate;
+    }
+
+    /*!
+     * @brief move the output to a target over a fixed time
+     *
+     * @param value the target value
+     * @param duration_us the time in microseconds to reach the target
+     * @param profile Ramp_Linear or Ramp_Exponential
+     */
+    void rampTo(const int value, const uint32_t duration_us,
+      const LT::RampProfile profile = LT::Ramp_Linear)
+    {
+      _target = value;
+      const int32_t diff = _target - _current;
+      if( duration_us == 0 || diff == 0 ) {
+        finish();
+        return;
+      }
+      _duration = duration_us;
+      _t_start = LT_current_time_us;
+      _t_step = _t_start;
+      if( profile == LT::Ramp_Exponential ) {
+        _fixed = _current * 256;
+        _step_us = duration_us / EXP_TICKS;
+        if( _step_us == 0 ) {
+          _step_us = 1;
+        }
+        _profile = LT::Ramp_Exponential;
+      }
+      else {
+        _start = _current;
+        _profile = LT::Ramp_Linear;
+      }
+    }
+
+    /*!
+     * @brief stop ramping and hold the current value
+     */
+    void stop() {
+      _target = _current;
+      _profile = LT::Ramp_None;
+    }
+
+    int getValue() const { return _current; }
+    int getTarget() const { return _target; }
+    bool isRamping() const { return _profile != LT::Ramp_None; }
+    LT::RampProfile getProfile() const { return _profile; }
+
+    void update() {
+      if( _profile == LT::Ramp_None ) return;
+      if( _profile != LT::Ramp_Rate && (LT_current_time_us - _t_start) >= _duration ) {
+        finish();
+        return;
+      }
+      if( _profile == LT::Ramp_Linear ) {
+        // the product can exceed 32 bits for long ramps over a wide range
+        const uint32_t elapsed = LT_current_time_us - _t_start;
+        write(_start + (int32_t)((int64_t)(_target - _start) * elapsed / _duration));
+        return;
+      }
+      const uint32_t ticks = (LT_current_time_us - _t_step) / _step_us;
+      if( ticks == 0 ) return;
+      _t_step += ticks * _step_us;
+      if( _profile == LT::Ramp_Exponential ) {
+        const int32_t target = _target * 256;
+        for( uint32_t i = 0; i < ticks && i < EXP_TICKS; ++i ) {
+          _fixed += (target - _fixed) >> EXP_SHIFT;
+        }
+        write((_fixed + 128) >> 8);
+      }
+      else {
+        stepToward(ticks);
+      }
+    }
+
+    LT_RampedOutput* instance() { return this; }
+};
+
+#endif //End __RAMPED_OUTPUT_H__ include guard
@@ -2,6 +2,7 @@
 #define __SENSOR_H__
 
 #include "device.h"
+#include "../utilities/delegate.h"
 
 typedef void(*Callback) ();
 
@@ -15,7 +16,7 @@ class LT_Sensor : public LT_Device {
     bool _polling;
     uint32_t _polling_interval_us = 50000;//50ms
     
-    Callback _newDataCallback = nullptr;
+    LT::Delegate<void()> _newDataCallback;
     
     private:
     volatile uint32_t _t_last_sample_us = 0;
@@ -41,7 +42,7 @@ class LT_Sensor : public LT_Device {
       return _polling_interval_us;
     }
     
-    void setNewDataCallback(Callback c) {
+    void setNewDataCallback(LT::Delegate<void()> c) {
       _newDataCallback = c;
     }
     
@@ -52,8 +53,8 @@ class LT_Sensor : public LT_Device {
     virtual void update() {
       if(_polling) {
         if( (LT_current_time_us - _t_last_sample_us) >= _polling_interval_us ) {
-          if( readSensor() == 0) {
-            (*_newDataCallback)();
+          if( readSensor() == 0 && _newDataCallback != nullptr ) {
+            _newDataCallback();
           }
           _t_last_sample_us = LT_current_time_us;
         }
@@ -0,0 +1,286 @@
+#ifndef __SOFT_PWM_H__
+#define __SOFT_PWM_H__
+
+#include "device.h"
+#include "step_timer.h"
+#include "../utilities/fast_pin.h"
+
+/*!
+ * @file soft_pwm.h
+ *
+ * LT_SoftPWM generates PWM on up to 16 pins of any kind, for boards that run
+ * out of analogWrite() pins or where tone() takes over the PWM timer.
+ *
+ * Each period starts by setting every channel with a non-zero duty high.
+ * The channels are then switched low from a schedule of edges sorted by
+ * time, with all channels that share a duty value switched by the same edge.
+ * The work per period scales with the number of distinct duty values, not
+ * with the PWM resolution.
+ *
+ * setValue() rebuilds the schedule into a second buffer, which is swapped
+ * in at the start of the next period, so a period is never cut short.
+ * Edges closer together than LT_SOFT_PWM_MIN_US are merged so the timer
+ * is never loaded with a compare value it has already passed.
+ *
+ * The edges are timed by update() or, for less jitter, by LT_StepTimer:
+ * LT_STEP_TIMER_ISR(heaters);
+ * heaters.setInterruptDriven(true);
+ *
+ * On the host, onStepTimer() can be called in a loop that advances a
+ * simulated clock by the returned time. With LT_SIMULATED_PINS defined,
+ * the outputs are written to LT::simulatedPins() and can be traced after
+ * each edge.
+ */
+
+#ifndef LT_SOFT_PWM_MIN_US
+#define LT_SOFT_PWM_MIN_US 20
+#endif
+
+/*!
+ * @tparam N_CHANNELS the number of PWM outputs (at most 16)
+ */
+template <uint8_t N_CHANNELS>
+class LT_SoftPWM : public LT_Device {
+    /*!
+     * @brief a group of channels that switch low at the same time
+     */
+    struct Edge {
+      uint32_t time; ///< time in microseconds from the start of the period
+      uint16_t mask; ///< bit i is set if channel i switches low
+    };
+
+    /*!
+     * @brief the edges of one PWM period
+     */
+    struct Schedule {
+      Edge edges[N_CHANNELS]; ///< edges sorted by time
+      uint8_t count; ///< the number of edges
+      uint16_t on_mask; ///< channels that are set high at the start of the period
+      uint32_t period; ///< the period in microseconds
+    };
+
+    int8_t _pins[N_CHANNELS]; ///< the pin number of each channel, -1 if unassigned
+#if defined(__AVR__) && !defined(LT_SIMULATED_PINS)
+    volatile uint8_t* _port_out[N_CHANNELS]; ///< the PORTx register of each channel
+    uint8_t _port_mask[N_CHANNELS]; ///< the port bit mask of each channel
+#endif
+    uint16_t _values[N_CHANNELS] = {0}; ///< the duty value of each channel
+    uint16_t _max_value = 255; ///< the duty value that is always on
+    uint32_t _period = 10000; ///< the PWM period in microseconds
+
+    Schedule _schedule[2]; ///< the active schedule and the one being built
+    volatile uint8_t _active = 0; ///< index of the schedule used by onStepTimer()
+    volatile bool _pending = false; ///< true when the other schedule is ready to be swapped in
+    uint8_t _next = 0; ///< index of the next edge in the active schedule
+    uint16_t _state = 0; ///< bit i is set while channel i is high
+
+    uint32_t _t_edge = 0; ///< the system time in microseconds of the last edge (polled mode)
+    uint32_t _wait = 0; ///< the time in microseconds from the last edge to the next edge (polled mode)
+    bool _interrupt_driven = false;
+
+    LT_ISR_ATTR void writePin(const uint8_t i, const bool high) {
+#if defined(LT_SIMULATED_PINS)
+      LT::simulatedPins()[_pins[i]] = high;
+#elif defined(__AVR__)
+      if( high ) *_port_out[i] |= _port_mask[i];
+      else *_port_out[i] &= ~_port_mask[i];
+#else
+      digitalWrite(_pins[i], high ? HIGH : LOW);
+#endif
+    }
+
+    // write the channels that differ between the current state and state
+    LT_ISR_ATTR void apply(const uint16_t state) {
+      uint16_t changed = _state ^ state;
+#if defined(__AVR__) && !defined(LT_SIMULATED_PINS)
+      const uint8_t sreg = SREG;
+      cli();
+#endif
+      for( uint8_t i = 0; changed; ++i, changed >>= 1 ) {
+        if( changed & 1 ) {
+          writePin(i, state & (1U << i));
+        }
+      }
+#if defined(__AVR__) && !defined(LT_SIMULATED_PINS)
+      SREG = sreg;
+#endif
+      _state = state;
+    }
+
+    // sort the channel duty values into the schedule that is not in use
+    void build() {
+      // the ISR does not swap while _pending is false, so the
+      // inactive schedule can be written after clearing it
+      _pending = false;
+      Schedule& s = _schedule[_active ^ 1];
+      s.count = 0;
+      s.on_mask = 0;
+      s.period = _period;
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        if( _pins[i] < 0 || _values[i] == 0 ) continue;
+        const uint32_t t = (uint32_t)((uint64_t)_period * _values[i] / _max_value);
+        if( t < LT_SOFT_PWM_MIN_US ) continue; // too short to time: off
+        s.on_mask |= (1U << i);
+        if( t + LT_SOFT_PWM_MIN_US > _period ) continue; // too close to the next period: on
+        // insertion sort, merging edges that are too close together
+        uint8_t j = 0;
+        while( j < s.count && s.edges[j].time + LT_SOFT_PWM_MIN_US <= t ) {
+          ++j;
+        }
+        if( j < s.count && s.edges[j].time < t + LT_SOFT_PWM_MIN_US ) {
+          s.edges[j].mask |= (1U << i);
+          continue;
+        }
+        for( uint8_t k = s.count; k > j; --k ) {
+          s.edges[k] = s.edges[k - 1];
+        }
+        s.edges[j].time = t;
+        s.edges[j].mask = (1U << i);
+        s.count++;
+      }
+      _pending = true;
+    }
+
+  public:
+    LT_SoftPWM(const uint8_t id) : LT_Device(id) {
+      static_assert(N_CHANNELS > 0 && N_CHANNELS <= 16, "LT_SoftPWM can have 1 to 16 channels");
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        _pins[i] = -1;
+      }
+      _schedule[0].count = 0;
+      _schedule[0].on_mask = 0;
+      _schedule[0].period = _period;
+    }
+
+    LT::DeviceType type() const { return LT::UserType; }
+
+    LT_SoftPWM* instance() { return this; }
+
+    /*!
+     * @brief assign a pin to a channel. The pin is set to an output and
+     * starts low.
+     *
+     * @param channel the index of the channel [0, N_CHANNELS)
+     * @param pin the digital pin number
+     * @return int8_t 0 on success, -1 if the channel or pin is not valid
+     */
+    int8_t setChannel(const uint8_t channel, const uint8_t pin) {
+      if( channel >= N_CHANNELS ) return -1;
+#if defined(__AVR__) && !defined(LT_SIMULATED_PINS)
+      const uint8_t port = digitalPinToPort(pin);
+      if( port == NOT_A_PIN ) return -1;
+      _port_out[channel] = portOutputRegister(port);
+      _port_mask[channel] = digitalPinToBitMask(pin);
+#endif
+      pinMode(pin, OUTPUT);
+      _pins[channel] = pin;
+      writePin(channel, false);
+      build();
+      return 0;
+    }
+
+    /*!
+     * @brief set the duty of a channel. The new value takes
+     * effect at the start of the next period
+     *
+     * @param channel the index of the channel
+     * @param value the duty from 0 (off) to the maximum value set
+     * by setResolution() (on)
+     */
+    void setValue(const uint8_t channel, uint16_t value) {
+      if( channel >= N_CHANNELS ) return;
+      if( value > _max_value ) {
+        value = _max_value;
+      }
+      _values[channel] = value;
+      build();
+    }
+
+    uint16_t getValue(const uint8_t channel) const {
+      return (channel < N_CHANNELS) ? _values[channel] : 0;
+    }
+
+    /*!
+     * @brief Set the PWM period in microseconds. The default is 10000 (100 Hz)
+     */
+    void setPeriod(const uint32_t period_us) {
+      _period = (period_us < 2 * LT_SOFT_PWM_MIN_US) ? 2 * LT_SOFT_PWM_MIN_US : period_us;
+      build();
+    }
+
+    uint32_t getPeriod() const { return _period; }
+
+    /*!
+     * @brief Set the number of bits of the duty value. The default
+     * is 8 bits (0-255), the same as analogWrite()
+     */
+    void setResolution(const uint8_t bits) {
+      if( bits < 1 || bits > 16 ) return;
+      const uint16_t max_value = (uint16_t)((1UL << bits) - 1);
+      for( uint8_t i = 0; i < N_CHANNELS; ++i ) {
+        _values[i] = (uint32_t)_values[i] * max_value / _max_value;
+      }
+      _max_value = max_value;
+      build();
+    }
+
+    /*!
+     * @brief Time the PWM edges with the LT_StepTimer interrupt instead of update().
+     * The sketch must connect the timer with LT_STEP_TIMER_ISR(pwm).
+     *
+     * @param enabled true to use the step timer
+     * @return true if the step timer is used, false if this board has no
+     * timer backend and update() still times the edges
+     */
+    bool setInterruptDriven(const bool enabled) {
+      if( enabled && !LT_StepTimer::available() ) {
+        return false;
+      }
+      _interrupt_driven = enabled;
+      if( enabled ) {
+        LT_StepTimer::begin();
+        LT_StepTimer::start(LT_SOFT_PWM_MIN_US);
+      }
+      else {
+        LT_StepTimer::stop();
+        _t_edge = LT_current_time_us;
+        _wait = 0;
+      }
+      return enabled;
+    }
+
+    void update() {
+      if( _interrupt_driven ) return;
+      const uint32_t dt = LT_current_time_us - _t_edge;
+      if( dt < _wait ) return;
+      // resynchronize instead of running a burst of late edges
+      _t_edge = (dt > _period) ? LT_current_time_us : (_t_edge + _wait);
+      _wait = onStepTimer();
+    }
+
+    /*!
+     * @brief Called from the step timer interrupt for each edge.
+     *
+     * @return uint32_t the time in microseconds until the next edge
+     */
+    LT_ISR_ATTR uint32_t onStepTimer() {
+      if( _next >= _schedule[_active].count ) {
+        // start of a period
+        if( _pending ) {
+          _active ^= 1;
+          _pending = false;
+        }
+        _next = 0;
+        const Schedule& s = _schedule[_active];
+        apply(s.on_mask);
+        return (s.count > 0) ? s.edges[0].time : s.period;
+      }
+      const Schedule& s = _schedule[_active];
+      const uint32_t t = s.edges[_next].time;
+      apply(_state & ~s.edges[_next].mask);
+      ++_next;
+      return ((_next < s.count) ? s.edges[_next].time : s.period) - t;
+    }
+};
+
+#endif //End __SOFT_PWM_H__ include guard
@@ -0,0 +1,85 @@
+#ifndef __SPEED_TABLE_H__
+#define __SPEED_TABLE_H__
+
+/*!
+ * @file speed_table.h
+ *
+ * LT_SpeedTable is a table of stepper step intervals that is generated at
+ * compile time and stored in program memory. Entry i holds the time in
+ * microseconds between steps at i * RPM_STEP hundredths of an RPM, so a speed
+ * change is a table lookup instead of a float division:
+ *
+ * // 4000 steps/rev, 0.5 RPM per entry, 0 to 63.5 RPM
+ * typedef LT_SpeedTable<4000, 50, 128> PumpSpeeds;
+ * mot.setSpeedIndex<PumpSpeeds>(20, true); // 10 RPM forward
+ *
+ * Entry 0 is 0 (stopped).
+ */
+
+namespace LT
+{
+  // compile time list of table indices [0, N)
+  template <uint16_t... I> struct IndexList {};
+  template <uint16_t N, uint16_t... I>
+  struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+  template <uint16_t... I>
+  struct MakeIndexList<0, I...> { typedef IndexList<I...> type; };
+
+  /*!
+   * @brief the step interval in microseconds at index * rpm_step hundredths of an RPM
+   * (1 min / 60,000,000 us) * (100 centi-RPM / 1 RPM) -> 6,000,000,000 / (resolution * centi-RPM)
+   */
+  constexpr uint32_t stepInterval(const uint16_t resolution, const uint16_t rpm_step, const uint16_t index) {
+    return (index == 0) ? 0 : (uint32_t)(6000000000ULL / ((uint64_t)resolution * rpm_step * index));
+  }
+
+  template <uint16_t RESOLUTION, uint16_t RPM_STEP, class INDICES>
+  struct SpeedTableData;
+
+  template <uint16_t RESOLUTION, uint16_t RPM_STEP, uint16_t... I>
+  struct SpeedTableData<RESOLUTION, RPM_STEP, IndexList<I...> > {
+    static const uint32_t intervals[sizeof...(I)];
+  };
+
+  template <uint16_t RESOLUTION, uint16_t RPM_STEP, uint16_t... I>
+  const uint32_t SpeedTableData<RESOLUTION, RPM_STEP, IndexList<I...> >::intervals[sizeof...(I)] PROGMEM = {
+    stepInterval(RESOLUTION, RPM_STEP, I)...
+  };
+}
+
+/*!
+ * @tparam RESOLUTION the number of steps per revolution of the motor
+ * @tparam RPM_STEP the speed increment between entries in hundredths of an RPM
+ * @tparam N_SPEEDS the number of entries in the table
+ */
+template <uint16_t RESOLUTION, uint16_t RPM_STEP, uint16_t N_SPEEDS>
+class LT_SpeedTable {
+    typedef LT::SpeedTableData<RESOLUTION, RPM_STEP,
+      typename LT::MakeIndexList<N_SPEEDS>::type> Data;
+    static_assert(RPM_STEP > 0, "RPM_STEP must be greater than 0");
+  public:
+    /*!
+     * @brief read a step interval from program memory
+     * @param index the speed index. Indices past the end of the table
+     * return the interval of the fastest speed
+     * @return the time in microseconds between steps, or 0 for index 0
+     */
+    static uint32_t interval(uint16_t index) {
+      if( index >= N_SPEEDS ) {
+        index = N_SPEEDS - 1;
+      }
+      return pgm_read_dword(&Data::intervals[index]);
+    }
+
+    /*!
+     * @brief the speed of an entry in hundredths of an RPM
+     */
+    static constexpr uint32_t centiRpm(const uint16_t index) {
+      return (uint32_t)index * RPM_STEP;
+    }
+
+    static constexpr uint16_t size() { return N_SPEEDS; }
+    static constexpr uint16_t resolution() { return RESOLUTION; }
+};
+
+#endif //End __SPEED_TABLE_H__ include guard
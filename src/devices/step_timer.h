@@ -0,0 +1,254 @@
+#ifndef __STEP_TIMER_H__
+#define __STEP_TIMER_H__
+
+/*!
+ * @file step_timer.h
+ *
+ * LT_StepTimer wraps one hardware timer compare channel that is used to
+ * generate step pulse edges independently of the DeviceManager loop.
+ * The timer runs in clear-on-compare mode, so each new compare value is
+ * measured from the previous edge and interrupt latency does not accumulate.
+ *
+ * AVR: Timer1, prescaler /8 (0.5us resolution at 16 MHz)
+ * ESP32: hardware timer 0, 1us resolution
+ * Host: with LT_SIMULATED_TIMER defined, a simulated counter that is
+ * advanced by the test with LT_StepTimer::advance()
+ * Other platforms do not have a timer backend and must use polled stepping.
+ * available() is false there, and setInterruptDriven(true) of the owner
+ * returns false and keeps stepping from update().
+ *
+ * Intervals shorter than LT_STEP_TIMER_MIN_US are lengthened to it, so
+ * the compare value is not one the counter has passed before the
+ * interrupt returns, which would stall the timer for a full count.
+ *
+ * Only one object can own the timer. Connect it in the sketch at global scope:
+ * LT_STEP_TIMER_ISR(motor);
+ * and enable it with motor.setInterruptDriven(true);
+ *
+ * @sa LT_Stepper
+ */
+
+#ifndef LT_STEP_TIMER_MIN_US
+#define LT_STEP_TIMER_MIN_US 10
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define LT_ISR_ATTR IRAM_ATTR
+#else
+#define LT_ISR_ATTR
+#endif
+
+// defined by LT_STEP_TIMER_ISR() in the sketch
+void LT_stepTimerHandler();
+
+class LT_StepTimer {
+#if defined(__AVR__)
+    static const uint32_t TICKS_PER_US = F_CPU / 8000000UL;
+    static const uint32_t MAX_US = 0xFFFFUL / TICKS_PER_US;
+#elif defined(ARDUINO_ARCH_ESP32)
+    static hw_timer_t*& handle() {
+      static hw_timer_t* t = nullptr;
+      return t;
+    }
+    static const uint32_t MAX_US = 0xFFFFFFFFUL;
+#elif defined(LT_SIMULATED_TIMER)
+    // as a 16 bit timer with 1us ticks, so long intervals are split as on AVR
+    static const uint32_t MAX_US = 0xFFFFUL;
+    struct Simulation {
+      uint32_t time;   ///< microseconds since the timer was started
+      uint32_t count;  ///< microseconds since the last compare match
+      uint32_t period; ///< the compare value
+    };
+    static Simulation& simulation() {
+      static Simulation s = {0, 0, 0};
+      return s;
+    }
+#else
+    // no timer backend on this platform
+    static const uint32_t MAX_US = 0xFFFFFFFFUL;
+#endif
+    // time in microseconds still to wait when an interval is
+    // longer than the timer can count in one compare period
+    static volatile uint32_t& remaining() {
+      static volatile uint32_t r = 0;
+      return r;
+    }
+    static volatile bool& active() {
+      static volatile bool a = false;
+      return a;
+    }
+
+    // load the compare register with the next period
+    static LT_ISR_ATTR void load(uint32_t us) {
+      if(us < LT_STEP_TIMER_MIN_US) {
+        us = LT_STEP_TIMER_MIN_US;
+      }
+      if(us > MAX_US) {
+        // wait half a period so the final period is never too short
+        // to be loaded before the counter passes it
+        remaining() = us - MAX_US / 2;
+        us = MAX_US / 2;
+      }
+      else {
+        remaining() = 0;
+      }
+#if defined(__AVR__)
+      OCR1A = (uint16_t)(us * TICKS_PER_US);
+#elif defined(ARDUINO_ARCH_ESP32)
+      timerAlarmWrite(handle(), us, true);
+#elif defined(LT_SIMULATED_TIMER)
+      simulation().period = us;
+#endif
+    }
+
+  public:
+    /*!
+     * @return true if this platform has a timer backend
+     */
+    static constexpr bool available() {
+#if defined(__AVR__) || defined(ARDUINO_ARCH_ESP32) || defined(LT_SIMULATED_TIMER)
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /*!
+     * @brief configure the timer hardware. The timer is left stopped
+     * until start() is called.
+     */
+    static void begin() {
+#if defined(__AVR__)
+      noInterrupts();
+      TCCR1A = 0;
+      TCCR1B = _BV(WGM12); // CTC mode, timer stopped
+      TIMSK1 &= ~_BV(OCIE1A);
+      interrupts();
+#elif defined(ARDUINO_ARCH_ESP32)
+      if(handle() == nullptr) {
+        handle() = timerBegin(0, 80, true); // 1us ticks from the 80 MHz APB clock
+        timerAttachInterrupt(handle(), &LT_stepTimerHandler, true);
+      }
+#endif
+    }
+
+    /*!
+     * @brief start the timer if it is idle. The first edge will be
+     * generated after delay_us
+     */
+    static void start(const uint32_t delay_us) {
+      if(!available() || active()) return;
+      active() = true;
+#if defined(__AVR__)
+      noInterrupts();
+      TCNT1 = 0;
+      load(delay_us);
+      TIFR1 = _BV(OCF1A);
+      TIMSK1 |= _BV(OCIE1A);
+      TCCR1B = _BV(WGM12) | _BV(CS11); // CTC mode, clk/8
+      interrupts();
+#elif defined(ARDUINO_ARCH_ESP32)
+      timerWrite(handle(), 0);
+      load(delay_us);
+      timerAlarmEnable(handle());
+#elif defined(LT_SIMULATED_TIMER)
+      simulation().count = 0;
+      load(delay_us);
+#else
+      (void)delay_us;
+#endif
+    }
+
+    /*!
+     * @brief stop the timer. Pending edges are not generated.
+     */
+    static LT_ISR_ATTR void stop() {
+#if defined(__AVR__)
+      TCCR1B = _BV(WGM12);
+      TIMSK1 &= ~_BV(OCIE1A);
+#elif defined(ARDUINO_ARCH_ESP32)
+      timerAlarmDisable(handle());
+#endif
+      active() = false;
+    }
+
+    static bool isActive() { return active(); }
+
+#if defined(LT_SIMULATED_TIMER)
+    /*!
+     * @brief run the simulated timer for us microseconds, calling
+     * LT_stepTimerHandler() at each compare match on the way
+     */
+    static void advance(uint32_t us) {
+      Simulation &s = simulation();
+      while(active() && us >= s.period - s.count) {
+        const uint32_t step = s.period - s.count;
+        us -= step;
+        s.time += step;
+        s.count = 0;
+        LT_stepTimerHandler();
+      }
+      if(active()) {
+        s.count += us;
+      }
+      s.time += us;
+    }
+
+    /*!
+     * @return the simulated time in microseconds, for timing edges in a test
+     */
+    static uint32_t now() { return simulation().time; }
+#endif
+
+    /*!
+     * @brief called from the timer interrupt before the owner is serviced
+     * @return true if the current interval has not finished yet and the
+     * owner should not be called.
+     */
+    static LT_ISR_ATTR bool waiting() {
+      const uint32_t r = remaining();
+      if(r == 0) {
+        return false;
+      }
+      load(r);
+      return true;
+    }
+
+    /*!
+     * @brief schedule the next edge. Called from the timer interrupt
+     * @param us the time in microseconds from the current edge to the
+     * next edge. 0 stops the timer.
+     */
+    static LT_ISR_ATTR void schedule(const uint32_t us) {
+      if(us == 0) {
+        stop();
+      }
+      else {
+        load(us);
+      }
+    }
+};
+
+/*!
+ * @brief connects the step timer interrupt to an object that implements
+ * uint32_t onStepTimer(), which returns the time in microseconds until
+ * the next edge (or 0 when it has nothing left to do).
+ */
+#if defined(__AVR__)
+#define LT_STEP_TIMER_ISR(owner) \
+  void LT_stepTimerHandler() { \
+    if(!LT_StepTimer::waiting()) { \
+      LT_StepTimer::schedule((owner).onStepTimer()); \
+    } \
+  } \
+  ISR(TIMER1_COMPA_vect) { LT_stepTimerHandler(); }
+#else
+#define LT_STEP_TIMER_ISR(owner) \
+  void LT_ISR_ATTR LT_stepTimerHandler() { \
+    if(!LT_StepTimer::waiting()) { \
+      LT_StepTimer::schedule((owner).onStepTimer()); \
+    } \
+  }
+#endif
+
+#endif //End __STEP_TIMER_H__ include guard
@@ -2,6 +2,10 @@
 #define __STEPPER__H__
 
 #include "device.h"
+#include "step_timer.h"
+#include "speed_table.h"
+#include "../utilities/fast_pin.h"
+#include "../utilities/ring_buffer.h"
 
 /*!
  * @file stepper.h
@@ -25,70 +29,253 @@
 
 typedef void(*intCallback) (int);
 
-class LT_Stepper : public LT_Device {
-    const uint8_t _step_pin; ///< digital input pin to control stepping
-    const uint8_t _dir_pin; ///< digital input pin to control direction
+// the number of step intervals buffered for interrupt driven stepping.
+// Must be a power of 2 and smaller than 256
+#ifndef LT_STEP_QUEUE_LENGTH
+#define LT_STEP_QUEUE_LENGTH 8
+#endif
+
+// the number of motion segments that can be queued on each stepper.
+// Must be a power of 2
+#ifndef LT_STEPPER_SEGMENT_QUEUE_LENGTH
+#define LT_STEPPER_SEGMENT_QUEUE_LENGTH 4
+#endif
+
+/*!
+ * @brief one segment of a queued stepper motion profile
+ */
+struct StepperSegment {
+  int32_t steps; ///< the signed number of steps to take
+  uint32_t interval; ///< the time in microseconds between steps at the segment speed
+  float acceleration; ///< the rate to ramp from the previous speed in steps/s^2. 0 changes speed immediately
+};
+
+/*!
+ * @brief a stepper motor driven by a step/direction driver
+ * 
+ * @tparam STEP_PIN the pin type of the step input, LT_Pin or FastPin<N>
+ * @tparam DIR_PIN the pin type of the direction input, LT_Pin or FastPin<N>
+ */
+template <class STEP_PIN = LT_Pin, class DIR_PIN = LT_Pin>
+class LT_BasicStepper : public LT_Device {
+    const STEP_PIN _step_pin; ///< digital input pin to control stepping
+    const DIR_PIN _dir_pin; ///< digital input pin to control direction
     const int8_t _enable_pin; ///< digital input pin to control power to the motor
     uint32_t _t_last_step; ///< the system time in microseconds that the last step was taken
     uint32_t _interval; ///< the time in microseconds to wait until setting step high
     uint32_t _pulse_width; ///< the minimum time in microseconds to hold a step pulse high
     uint16_t _resolution; ///< the number of steps per revolution of the motor. Used in position measurements.
-    int16_t _position; ///< the current position of the motor from [0 resolution]
-    int16_t _steps_remaining; ///< the number of steps remaining until the motor has reached its target position
+    volatile int32_t _position; ///< the absolute position of the motor in steps
+    volatile int32_t _steps_remaining; ///< the number of steps remaining until the motor has reached its target position
     bool _direction;
-    bool _running;
-    bool _stepping;
+    volatile bool _running;
+    volatile bool _stepping;
     bool _enabled;
+    bool _interrupt_driven = false; ///< true if step pulses are generated by LT_StepTimer
+    int32_t _steps_unqueued; ///< the number of steps that have not been added to the interval queue yet
+    uint32_t _isr_wait; ///< the time in microseconds from the falling edge of a pulse to the next rising edge
+    uint32_t _queue[LT_STEP_QUEUE_LENGTH]; ///< step intervals waiting to be consumed by the timer interrupt
+    volatile uint8_t _q_head = 0; ///< written only by the loop. single byte so reads are atomic on AVR
+    volatile uint8_t _q_tail = 0; ///< written only by the timer interrupt
+    bool _plan_direction; ///< the direction of the steps being added to the interval queue
+    RingBuffer<LT_STEPPER_SEGMENT_QUEUE_LENGTH, StepperSegment> _segments; ///< motion segments waiting to run
+    uint32_t _target_interval; ///< the step interval at the speed of the current segment
+    float _acceleration = 0; ///< the acceleration of the current segment in steps/s^2
+    float _ramp_interval; ///< the step interval while ramping towards _target_interval
+    int32_t _ramp_step; ///< the number of steps it would take to reach the ramp speed from rest
+
+    static const uint32_t DIRECTION_FLAG = 0x80000000UL; ///< marks forward steps in the interval queue
     //go ahead, take a step
     void step() {
         // finish a step
         if(_stepping) {
             if( (LT_current_time_us - _t_last_step) >= _pulse_width ) {
-                digitalWrite( _step_pin, LOW );
+                _step_pin.write( LOW );
                 _stepping = false;
-                updatePosition( (_direction == true) ? _position++ : _position--);
             }
         }
         // start a step
         else {
             if( (LT_current_time_us - _t_last_step) >= _interval ) {
-                digitalWrite( _step_pin, HIGH );
+                _step_pin.write( HIGH );
                 _t_last_step += _interval;
                 _stepping = true;
+                countStep();
             }
         }
     }
     // update the position variable
-    // this function is called whenever a step is completed
-    // example: for a motor with 200 steps/rev, the position can be [0, 199]
-    void updatePosition(const int16_t position) {
-        _position = position;
-        if( _position >= _resolution ){
-            _position = 0;
+    // this function is called on the rising edge of every step so that
+    // the step is counted in the direction the driver latched
+    void countStep() {
+        if( _direction == true ) {
+          _position = _position + 1;
         }
-        else if( _position < 0 ) {
-            _position = _resolution - 1;
+        else {
+          _position = _position - 1;
         }
         // check if a target position was set
         if( _steps_remaining > 0 ) {
-          _steps_remaining--;
+          _steps_remaining = _steps_remaining - 1;
+          if( _steps_remaining == 0 ) {
+            // chain the next segment on the following step.
+            // in interrupt driven mode the loop has already planned it
+            if( _interrupt_driven || !nextSegment() ) {
+              _steps_remaining = -1;
+              _running = false;
+            }
+          }
+          else if( !_interrupt_driven ) {
+            _interval = nextInterval();
+          }
         }
-        if( _steps_remaining == 0 ) {
-          _steps_remaining = -1;
-          _running = false;
+    }
+
+    // set up the acceleration ramp for a new segment and return the
+    // interval to the first step of the segment
+    // from_interval is the current step interval, or 0 if the motor is stopped
+    uint32_t beginRamp(const StepperSegment &segment, const uint32_t from_interval) {
+      _target_interval = segment.interval;
+      _acceleration = segment.acceleration;
+      if( _acceleration <= 0 ) {
+        return _target_interval;
+      }
+      if( from_interval == 0 ) {
+        // first step from rest (Austin, "Generate stepper-motor speed profiles in real time")
+        _ramp_step = 0;
+        _ramp_interval = 676000.0 * sqrt(2.0 / _acceleration);
+        if( _ramp_interval < _target_interval ) {
+          _ramp_interval = _target_interval;
+        }
+        return _ramp_interval;
+      }
+      // continue the ramp from the current speed
+      const float speed = 1000000.0 / from_interval;
+      _ramp_step = speed * speed / (2.0 * _acceleration);
+      _ramp_interval = from_interval;
+      return nextInterval();
+    }
+
+    // advance the acceleration ramp by one step
+    // and return the interval to the next step
+    uint32_t nextInterval() {
+      if( _acceleration <= 0 ) {
+        return _target_interval;
+      }
+      if( _ramp_interval > _target_interval ) {
+        // speed up
+        _ramp_step++;
+        _ramp_interval -= 2.0 * _ramp_interval / (4.0 * _ramp_step + 1.0);
+        if( _ramp_interval < _target_interval ) {
+          _ramp_interval = _target_interval;
+        }
+      }
+      else if( _ramp_interval < _target_interval ) {
+        // slow down
+        if( _ramp_step > 1 ) {
+          _ramp_interval += 2.0 * _ramp_interval / (4.0 * _ramp_step - 1.0);
+          _ramp_step--;
         }
+        if( _ramp_step <= 1 || _ramp_interval > _target_interval ) {
+          _ramp_interval = _target_interval;
+        }
+      }
+      return _ramp_interval;
+    }
+
+    // start the next queued segment when stepping from update()
+    bool nextSegment() {
+      StepperSegment segment;
+      if( _segments.takeBack(&segment) != 0 ) {
+        return false;
+      }
+      const bool forward = ( segment.steps > 0 );
+      setDirection(forward);
+      _steps_remaining = forward ? segment.steps : -segment.steps;
+      _interval = beginRamp(segment, _running ? _interval : 0);
+      _running = true;
+      return true;
+    }
+
+    // add the next queued segment to the interval queue plan
+    // when stepping from the step timer
+    bool planSegment() {
+      StepperSegment segment;
+      if( _segments.takeBack(&segment) != 0 ) {
+        return false;
+      }
+      _plan_direction = ( segment.steps > 0 );
+      const int32_t steps = _plan_direction ? segment.steps : -segment.steps;
+      _interval = beginRamp(segment, _running ? _interval : 0);
+      _steps_unqueued = steps;
+      noInterrupts();
+      _steps_remaining = (_steps_remaining > 0) ? _steps_remaining + steps : steps;
+      _running = true;
+      interrupts();
+      return true;
+    }
+
+    // read a variable shared with the step timer interrupt.
+    // 32-bit reads are not atomic on AVR
+    int32_t atomicRead(const volatile int32_t &value) const {
+      if( !_interrupt_driven ) {
+        return value;
+      }
+      noInterrupts();
+      const int32_t copy = value;
+      interrupts();
+      return copy;
     }
     
-    void checkDirection(float rpm) {
-      bool isCCW = ( rpm > 0 );
-      if( isCCW != _direction ) {
-        _direction = isCCW;
-        digitalWrite( _dir_pin, _direction );
+    void checkDirection(const bool isCCW) {
+      if( _interrupt_driven ) {
+        // the timer interrupt sets the pin when it reaches the first step
+        _plan_direction = isCCW;
+      }
+      else {
+        setDirection(isCCW);
+      }
+    }
+
+    // top up the interval queue consumed by onStepTimer()
+    // and start the timer if it has stopped
+    void fillQueue() {
+      while( (uint8_t)(_q_head - _q_tail) < LT_STEP_QUEUE_LENGTH ) {
+        if( _steps_unqueued == 0 && !planSegment() ) {
+          break;
+        }
+        _queue[_q_head & (LT_STEP_QUEUE_LENGTH - 1)] = 
+          _plan_direction ? (_interval | DIRECTION_FLAG) : _interval;
+        _q_head++;
+        if( _steps_unqueued > 0 ) {
+          _steps_unqueued--;
+          if( _steps_unqueued > 0 ) {
+            _interval = nextInterval();
+          }
+        }
+      }
+      if( _q_head != _q_tail ) {
+        LT_StepTimer::start(_pulse_width);
+      }
+    }
+
+    // discard intervals that have not been started yet
+    void flushQueue() {
+      noInterrupts();
+      const uint8_t flushed = _q_head - _q_tail;
+      _q_head = _q_tail;
+      if( _steps_remaining > 0 ) {
+        // flushed steps will not be counted by the interrupt
+        _steps_remaining = _steps_remaining - flushed;
+        if( _steps_remaining <= 0 ) {
+          _steps_remaining = -1;
+        }
       }
+      interrupts();
     }
   public:
-    LT_Stepper(const uint8_t id, const uint8_t step_pin, const uint8_t dir_pin,
-    const int8_t enable_pin = -1) : LT_Device(id), _step_pin(step_pin), 
+    LT_BasicStepper(const uint8_t id, const STEP_PIN step_pin = STEP_PIN(), 
+    const DIR_PIN dir_pin = DIR_PIN(), const int8_t enable_pin = -1) : LT_Device(id), _step_pin(step_pin), 
     _dir_pin(dir_pin), _enable_pin(enable_pin) {}
     
     virtual LT::DeviceType type() const { return LT::Stepper; }
@@ -100,12 +287,14 @@ class LT_Stepper : public LT_Device {
         _resolution = 200;
         _position = 0;
         _steps_remaining = -1;
+        _steps_unqueued = 0;
         _direction = true;
+        _plan_direction = true;
         _running = false;
         _stepping = false;
         _enabled = true;
-        pinMode( _step_pin, OUTPUT );
-        pinMode( _dir_pin, OUTPUT );
+        _step_pin.mode( OUTPUT );
+        _dir_pin.mode( OUTPUT );
         if(_enable_pin < 0) {
           // an enable pin was not specified
         }
@@ -113,16 +302,122 @@ class LT_Stepper : public LT_Device {
           pinMode( _enable_pin, OUTPUT );
           setEnabled(true);
         }
-        digitalWrite( _step_pin,LOW );
-        digitalWrite( _dir_pin, _direction );
+        _step_pin.write( LOW );
+        _dir_pin.write( _direction );
 
     }
     void update() {
-        if( _running || _stepping ) {
+        if( _interrupt_driven ) {
+            if( _running || !_segments.isEmpty() ) {
+                fillQueue();
+            }
+        }
+        else if( _running || _stepping ) {
             step();
         }
+        else if( nextSegment() ) {
+            _t_last_step = LT_current_time_us;
+        }
+    }
+
+    /**
+     * @brief Generate step pulses from the LT_StepTimer interrupt instead
+     * of from update(). update() then only refills a short queue of step
+     * intervals, so the step rate is no longer limited by the loop time.
+     * The sketch must connect the timer with LT_STEP_TIMER_ISR(motor).
+     * 
+     * @param enabled true to use the step timer
+     * @return true if the step timer is used, false if this board has no
+     * timer backend and update() still generates the pulses
+     */
+    bool setInterruptDriven(const bool enabled) {
+      if( enabled ) {
+        if( !LT_StepTimer::available() ) {
+          return false;
+        }
+        LT_StepTimer::begin();
+      }
+      else {
+        LT_StepTimer::stop();
+        flushQueue();
+        if( _stepping ) {
+          _step_pin.write( LOW );
+          _stepping = false;
+        }
+        _t_last_step = LT_current_time_us;
+      }
+      _interrupt_driven = enabled;
+      return enabled;
+    }
+
+    /**
+     * @brief Called from the step timer interrupt for each pulse edge.
+     * 
+     * @return uint32_t the time in microseconds until the next edge,
+     * or 0 if there are no queued steps.
+     */
+    LT_ISR_ATTR uint32_t onStepTimer() {
+      if( _stepping ) {
+        // finish a step
+        _step_pin.write( LOW );
+        _stepping = false;
+        return _isr_wait;
+      }
+      if( _q_head == _q_tail ) {
+        // queue ran dry, wait for the loop to restart the timer
+        return 0;
+      }
+      const uint32_t entry = _queue[_q_tail & (LT_STEP_QUEUE_LENGTH - 1)];
+      const bool forward = ( (entry & DIRECTION_FLAG) != 0 );
+      if( forward != _direction ) {
+        // change direction and give the driver setup time before stepping
+        setDirection(forward);
+        return _pulse_width;
+      }
+      // start a step
+      const uint32_t interval = entry & ~DIRECTION_FLAG;
+      _q_tail++;
+      _step_pin.write( HIGH );
+      _stepping = true;
+      countStep();
+      _isr_wait = (interval > 2 * _pulse_width) ? (interval - _pulse_width) : _pulse_width;
+      return _pulse_width;
+    }
+    LT_BasicStepper* instance() { return this; }
+
+    /**
+     * @brief Set the direction pin without starting a move. Used by
+     * external step sources such as LT_MotionGroup.
+     * 
+     * @param forward true to count steps up, false to count steps down
+     */
+    LT_ISR_ATTR void setDirection(const bool forward) {
+      if( forward != _direction ) {
+        _direction = forward;
+        _dir_pin.write( _direction );
+      }
     }
-    LT_Stepper* instance() { return this; }
+
+    /**
+     * @brief Set the step pin high and count the step in the current
+     * direction. The caller is responsible for holding the pulse for
+     * at least getPulseWidth() before calling endPulse().
+     */
+    LT_ISR_ATTR void beginPulse() {
+      _step_pin.write( HIGH );
+      _stepping = true;
+      countStep();
+    }
+
+    /**
+     * @brief Set the step pin low.
+     */
+    LT_ISR_ATTR void endPulse() {
+      _step_pin.write( LOW );
+      _stepping = false;
+    }
+
+    uint32_t getPulseWidth() const { return _pulse_width; }
 
     void setEnabled(const bool enabled) {
       if(_enable_pin < 0) return;
@@ -131,6 +426,17 @@ class LT_Stepper : public LT_Device {
       _enabled = enabled;
     }
     
+    /**
+     * @brief Set the time to hold the step pin high for each step.
+     * The maximum step rate is 1 / (2 * pulse_width).
+     * 
+     * @param pulse_width the pulse width in microseconds. Check the
+     * minimum value in the motor driver datasheet (A4988: 1us, DRV8825: 2us)
+     */
+    void setPulseWidth(const uint32_t pulse_width) {
+      _pulse_width = pulse_width;
+    }
+
     void setResolution(const uint16_t resolution) {
       _resolution = resolution;
     }
@@ -139,20 +445,55 @@ class LT_Stepper : public LT_Device {
         // resolution is the number of steps to make a revolution
         // (1 rev / 1 min) * (1 min / 60,000,000 us) * (_resolution / 1 rev) = _resolution (steps) / us
         if(rpm == 0) {
+          setInterval(0, _direction);
+        }
+        else if(rpm < 0) {
+          setInterval(60000000.0 / ( (float)(_resolution) * -rpm), false);
+        }
+        else {
+          setInterval(60000000.0 / ( (float)(_resolution) * rpm), true);
+        }
+    }
+
+    /**
+     * @brief Set the speed of the motor from a step interval without
+     * any float calculations. Intervals can be read from an LT_SpeedTable.
+     * 
+     * \sa getInterval()
+     * 
+     * @param interval the time in microseconds between steps. 0 stops the motor.
+     * @param forward true for clockwise rotation (the direction of positive RPM)
+     */
+    void setInterval(const uint32_t interval, const bool forward) {
+        // a new speed replaces any queued motion profile
+        _segments.reset();
+        _acceleration = 0;
+        flushQueue();
+        if(interval == 0) {
           _running = false;
+          _steps_unqueued = 0;
         }
         else {
-          checkDirection(rpm);
-          if(rpm < 0) {
-            rpm = -rpm;
-          }
-          else {}
-          
-          _interval = 60000000.0 / ( (float)(_resolution) * rpm);
+          checkDirection(forward);
+          _interval = interval;
+          _target_interval = _interval;
           _t_last_step = LT_current_time_us;
+          // keep counting down to a target if one was set
+          _steps_unqueued = (_steps_remaining > 0) ? atomicRead(_steps_remaining) : -1;
           _running = true;
         }
     }
+
+    /**
+     * @brief Set the speed of the motor from a compile time speed table.
+     * 
+     * @param index the index of the speed in the table. 0 stops the motor.
+     * @param forward true for clockwise rotation (the direction of positive RPM)
+     */
+    template <class TABLE>
+    void setSpeedIndex(const uint16_t index, const bool forward) {
+        setInterval(TABLE::interval(index), forward);
+    }
     /**************************************************************************/
     /*!
     @brief Read the current speed of the motor
@@ -189,16 +530,17 @@ class LT_Stepper : public LT_Device {
     uint16_t getResolution() const { return _resolution; }
     
     /**
-     * @brief Set the current position of the motor. This does not
+     * @brief Set the current absolute position of the motor. This does not
      * instruct the motor to turn. Used for setting an index
-     * or zero position. To turn the motor to a specific angle,
-     * use \sa rotate().
+     * or zero position. To turn the motor to a specific position,
+     * use \sa moveTo().
      * 
-     * @param position a position between 0 and _resolution.
-     * Common _resolution values are 200, 400, 800, 1600
+     * @param position the absolute position in steps
      */
-    void setPosition(const uint16_t position) {
-      updatePosition(position);
+    void setPosition(const int32_t position) {
+      if( _interrupt_driven ) noInterrupts();
+      _position = position;
+      if( _interrupt_driven ) interrupts();
     }
     
     /**
@@ -208,7 +550,7 @@ class LT_Stepper : public LT_Device {
      * values for anti-clockwise rotation
      * @param rpm The speed of rotation in RPM
      */
-    void rotate(int16_t steps, float rpm) {
+    void rotate(int32_t steps, float rpm) {
       // save the starting point
       if(steps == 0 || rpm == 0) return;
       if(steps < 0) {
@@ -216,27 +558,137 @@ class LT_Stepper : public LT_Device {
         rpm = -rpm;
       }
       setSpeed(rpm);
+      if( _interrupt_driven ) noInterrupts();
       _steps_remaining = steps;
+      if( _interrupt_driven ) interrupts();
+      _steps_unqueued = steps;
+    }
+
+    /**
+     * @brief Move the motor by a number of steps relative to
+     * its current position.
+     * 
+     * @param delta the number of steps to move. Negative values
+     * move towards lower positions.
+     * @param rpm the speed of rotation in RPM. The sign is ignored.
+     */
+    void move(const int32_t delta, const float rpm) {
+      rotate(delta, (rpm < 0) ? -rpm : rpm);
+    }
+
+    /**
+     * @brief Move the motor to an absolute position. A move that is
+     * in progress is replaced.
+     * 
+     * @param target the absolute position in steps
+     * @param rpm the speed of rotation in RPM. The sign is ignored.
+     */
+    void moveTo(const int32_t target, const float rpm) {
+      move(target - currentPosition(), rpm);
     }
     
+    /**
+     * @brief Add a segment to the motion queue. Queued segments run one
+     * after the other, and each segment starts on the step after the previous
+     * segment finishes. If the motor is stopped, the first segment starts
+     * on the next update(). rotate(), move(), moveTo() and setSpeed() 
+     * discard queued segments.
+     * 
+     * Each segment ramps from the speed of the previous segment to its own
+     * speed. To stop smoothly, end the profile with a slow segment.
+     * 
+     * @param steps the number of steps to take. Use negative (-)
+     * values for anti-clockwise rotation
+     * @param rpm the speed of the segment in RPM. The sign is ignored.
+     * @param acceleration the rate to change from the previous speed
+     * in RPM/s. 0 changes speed immediately.
+     * @return true if there was room in the queue
+     */
+    bool queueSegment(const int32_t steps, float rpm, const float acceleration = 0) {
+      if( steps == 0 || rpm == 0 ) return false;
+      if( rpm < 0 ) {
+        rpm = -rpm;
+      }
+      StepperSegment segment;
+      segment.steps = steps;
+      segment.interval = 60000000.0 / ( (float)(_resolution) * rpm);
+      segment.acceleration = acceleration * _resolution / 60.0;
+      // the step timer interrupt does not access the segment queue
+      return ( _segments.put(segment) == 0 );
+    }
+
+    /**
+     * @brief 
+     * 
+     * @return uint8_t the number of segments waiting in the motion queue.
+     * The segment that is running is not included.
+     */
+    uint8_t queuedSegments() const { return _segments.count(); }
+
+    /**
+     * @brief 
+     * 
+     * @return uint8_t the number of segments that can still be queued
+     */
+    uint8_t segmentQueueAvailable() const { return _segments.size() - _segments.count(); }
+
+    /**
+     * @brief 
+     * 
+     * @return int32_t the number of steps between the current position 
+     * and the target position. Negative if the target is at a lower
+     * position. 0 if the motor is not moving to a target.
+     */
+    int32_t distanceToGo() const {
+      const int32_t remaining = atomicRead(_steps_remaining);
+      if( remaining <= 0 ) {
+        return 0;
+      }
+      return _direction ? remaining : -remaining;
+    }
+
     /**
      * @brief 
      * 
-     * @return int16_t the number of steps between the current position 
-     * and the target position
+     * @return int32_t the absolute position the motor is moving to.
+     * If the motor is not moving to a target, the current position.
      */
-    int16_t distanceToGo() const {
-      return _steps_remaining;
+    int32_t targetPosition() const {
+      return currentPosition() + distanceToGo();
     }
+
+    /**************************************************************************/
+    /*!
+    @brief read the absolute software position of the motor in steps. This is
+    the not the target position and will change if the motor is rotating.
+    @return the number of steps counted since the position was last set
+    */
+    /**************************************************************************/
+    int32_t currentPosition() const {return atomicRead(_position);}
     
     /**************************************************************************/
     /*!
-    @brief read the current software postion of the motor. This is the not the 
-    target position and will change if the motor is rotating.
+    @brief read the position of the motor within one revolution.
     @return returns a value between 0 and _resolution
     */
     /**************************************************************************/
-    uint16_t getPosition() const {return _position;}
+    uint16_t getPosition() const {
+      int32_t position = currentPosition() % (int32_t)_resolution;
+      if( position < 0 ) {
+        position += _resolution;
+      }
+      return position;
+    }
+
+    /**************************************************************************/
+    /*!
+    @brief read the angle of the motor within one revolution.
+    @return returns an angle in degrees between 0 and 360
+    */
+    /**************************************************************************/
+    float getAngle() const {
+      return getPosition() * 360.0 / _resolution;
+    }
     
     /**************************************************************************/
     /*!
@@ -248,4 +700,6 @@ class LT_Stepper : public LT_Device {
     
 };
 
+typedef LT_BasicStepper<> LT_Stepper;
+
 #endif //End __STEPPER__H__ include guard
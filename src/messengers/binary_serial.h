@@ -5,9 +5,55 @@
 // See also CRC-8-CCITT: http://www.nongnu.org/avr-libc/user-manual/group__util__crc.html#gab27eaaef6d7fd096bd7d57bf3f9ba083
 // https://lentz.com.au/blog/calculating-crc-with-a-tiny-32-entry-lookup-table
 
+#include "commands.h"
+#include "payload.h"
 #include "../utilities/crc.h"
+#include "../utilities/delegate.h"
+#include "../utilities/ring_buffer.h"
 
-#define MAX_MESSAGE_LENGTH 64 //< size of the incoming message buffer. Must be smaller than 256 [sizeof(uint8_t)]
+#ifndef BINARY_SERIAL_MESSAGE_LENGTH
+#define BINARY_SERIAL_MESSAGE_LENGTH 64 //< default size of the incoming message buffer, including the 4-byte checksum
+#endif
+
+#ifndef BINARY_SERIAL_RX_BLOCK
+#define BINARY_SERIAL_RX_BLOCK 16 //< bytes read from the stream at a time by update(), on the stack
+#endif
+
+#ifndef BINARY_SERIAL_TX_BLOCK
+#if defined(__AVR__)
+#define BINARY_SERIAL_TX_BLOCK 32 //< bytes escaped on the stack before each write() by sendPacket()
+#else
+#define BINARY_SERIAL_TX_BLOCK 138 //< a whole escaped 64 byte message, written with one write()
+#endif
+#endif
+
+// bytes of escaped frames that can wait in each transmit lane, a power of 2.
+// 0 disables the queue: sendPacket() writes directly and can block
+#ifndef BINARY_SERIAL_TX_QUEUE
+#if defined(__AVR__)
+#define BINARY_SERIAL_TX_QUEUE 0
+#else
+#define BINARY_SERIAL_TX_QUEUE 256
+#endif
+#endif
+
+#ifndef BINARY_SERIAL_TX_FRAMES
+#define BINARY_SERIAL_TX_FRAMES 8 //< frames that can wait in each transmit lane, a power of 2
+#endif
+
+namespace LT {
+  /*!
+   * @brief the packet framing used by BinarySerial. Both ends of a link must match
+   */
+  enum Framing : uint8_t {
+    Framing_SLIP = 0, ///< RFC 1055, up to twice the message length on the wire
+    Framing_COBS = 1  ///< Consistent Overhead Byte Stuffing, at most 1 byte per 254
+  };
+}
+
+#ifndef BINARY_SERIAL_FRAMING
+#define BINARY_SERIAL_FRAMING LT::Framing_SLIP //< the framing of the BinarySerial typedef
+#endif
 
 typedef void (*intCallback)(int);
 
@@ -15,9 +61,26 @@ typedef void (*intCallback)(int);
 * Data are encoded using Serial Line IP (SLIP) packet framing (RFC 1055) with a 32-bit checksum
 * format: <END><message><crc><END>
 *
+* With Framing_COBS, Consistent Overhead Byte Stuffing is used instead
+* format: <0x00><COBS encoded message and crc><0x00>
+* A 0x00 only appears as a delimiter, and each run of up to 254 non-zero
+* bytes costs one extra byte, so the frame length is bounded whatever
+* the data.
+*
+* Messages that are larger than a frame can be sent in pieces with sendFragmented().
+* Each piece is a Fragment message: <Fragment><offset><total length><data>
+* with 16-bit little-endian offset and length. A receiver with a
+* reassembly buffer joins the pieces and handles them as one message.
+*
+* @tparam MESSAGE_LENGTH the size of the incoming message buffer, including the checksum
+* @tparam REASSEMBLY_LENGTH the largest fragmented message that can be received. 0 passes
+* fragments to the message received callback unchanged
+* @tparam FRAMING Framing_SLIP or Framing_COBS
+*
 * @sa ASCIISerial
 */
-class BinarySerial
+template <uint16_t MESSAGE_LENGTH, uint16_t REASSEMBLY_LENGTH = 0, LT::Framing FRAMING = BINARY_SERIAL_FRAMING>
+class BasicBinarySerial
 {
   const uint8_t END = 0xC0;     ///<  Frame end
   const uint8_t ESC = 0xDB;     ///<  Frame escape
@@ -35,14 +98,44 @@ class BinarySerial
     MESSAGE_FORMAT = 3       //< recieved data was empty or did not contain a formatted message
   };
 
+  static const uint8_t FRAGMENT_HEADER = 5; ///< function code, offset and total length of a fragment
+
   Stream *_com = nullptr;
-  intCallback _rx_callback = nullptr;
-  intCallback _tx_callback = nullptr;
-  intCallback _error_callback = nullptr;
+  LT::Delegate<void(int)> _rx_callback;
+  LT::Delegate<void(int)> _tx_callback;
+  LT::Delegate<void(int)> _error_callback;
 
-  uint8_t _message[MAX_MESSAGE_LENGTH];
-  volatile uint8_t _msg_idx = 0;
+  uint8_t _message[MESSAGE_LENGTH];
+  volatile uint16_t _msg_idx = 0;
   volatile bool _escaped = false;
+  uint8_t _cobs_code = 0;      ///< the code byte of the COBS block being received, 0 at the start of a frame
+  uint8_t _cobs_remaining = 0; ///< data bytes left in that block
+  uint32_t _rx_crc = 0xFFFFFFFF; ///< CRC register of the received bytes, except the last four
+  uint16_t _rx_budget = 0; ///< the most bytes read per update, 0 for no limit
+  uint32_t _rx_time_budget_us = 0; ///< the most time spent reading per update, 0 for no limit
+
+  uint8_t _assembly[REASSEMBLY_LENGTH + 4]; ///< fragments joined into one message, followed by its checksum
+  uint16_t _assembly_length = 0; ///< the length of the message being reassembled, 0 if none
+  uint16_t _assembly_received = 0; ///< the number of bytes of the message received so far
+  LT::CRC32 _assembly_crc; ///< the checksum of the message received so far
+  bool _assembled = false; ///< true while a reassembled message is being handled
+
+#if BINARY_SERIAL_TX_QUEUE > 0
+  /*!
+   * @brief a queue of escaped frames waiting for room in the stream
+   */
+  struct TxLane
+  {
+    RingBuffer<BINARY_SERIAL_TX_QUEUE, uint8_t> bytes; ///< the escaped frames
+    RingBuffer<BINARY_SERIAL_TX_FRAMES, uint16_t> lengths; ///< the length of each frame
+  };
+  TxLane _tx_lanes[2];             ///< the bulk lane [0] and the priority lane [1]
+  TxLane *_tx_target = nullptr;    ///< the lane that sendPacket() is writing to, nullptr for the stream
+  TxLane *_tx_lane = nullptr;      ///< the lane of the frame being written to the stream
+  uint16_t _tx_remaining = 0;      ///< bytes of that frame still to be written
+  uint16_t _tx_dropped = 0;        ///< frames dropped because their lane was full
+  bool _tx_queue_enabled = true;   ///< false to always write directly to the stream
+#endif
 
   /*!
   * @brief executes the message recieved callback if a message with more than 4 bytes was received
@@ -56,14 +149,18 @@ class BinarySerial
       // read the last four bytes
       uint32_t checksum = 0;
       read(&_message[_msg_idx - 4], checksum);
-      // check the crc
-      if (checksum == crc32(_message, _msg_idx - 4))
+      // the crc of the rest of the message was updated as it arrived
+      if (checksum == ~_rx_crc)
       {
-        if (_rx_callback != nullptr)
+        if (REASSEMBLY_LENGTH > 0 && _message[0] == LT::Fragment)
+        {
+          reassemble();
+        }
+        else if (_rx_callback != nullptr)
         {
           // handle the message with the callback functin
           // msg_idx is the number of bytes in the packet, including the checksum bytes if applicable
-          (*_rx_callback)(_msg_idx);
+          _rx_callback(_msg_idx);
         }
       }
       else
@@ -71,7 +168,7 @@ class BinarySerial
         //bad checksum
         if (_error_callback != nullptr)
         {
-          (*_error_callback)(INVALID_CHECKSUM);
+          _error_callback(INVALID_CHECKSUM);
         }
       }
     }
@@ -81,106 +178,317 @@ class BinarySerial
       // there is no data in the packet, ignore it.
       // can optionally send a message format error
       /*if (_error_callback != nullptr) {
-        (*_error_callback)(MESSAGE_FORMAT);
+        _error_callback(MESSAGE_FORMAT);
       }*/
     }
     _msg_idx = 0;
+    _rx_crc = 0xFFFFFFFF;
   }
+
   /*!
-  * @brief Encode and write a byte to the communication stream.
-  * Data is sent using SLIP encoding.
+  * @brief add the Fragment message in the message buffer to the reassembly
+  * buffer, and handle the message when it is complete
   */
-  inline void encode(const uint8_t value)
+  void reassemble()
   {
-    if (value == END)
+    LT::PayloadReader in(&_message[1], _msg_idx - 5);
+    const uint16_t offset = in.read<uint16_t>();
+    const uint16_t total = in.read<uint16_t>();
+    const uint16_t n = in.remaining();
+    if (offset == 0)
     {
-      // if value is the same code as an END character, send a
-      // special two character code so as not to make the
-      // receiver think we sent an END
-      _com->write(ESC);
-      _com->write(ESC_END);
+      // the first fragment always starts a new message
+      _assembly_length = total;
+      _assembly_received = 0;
+      _assembly_crc.reset();
     }
-    else if (value == ESC)
+    if (!in.ok() || offset != _assembly_received || total != _assembly_length)
     {
-      // if value is the same code as an ESC character,
-      // send a special two character code so as not
-      // to make the receiver think we sent an ESC
-      _com->write(ESC);
-      _com->write(ESC_ESC);
+      // a missing or malformed fragment: drop the message. The rest of
+      // its fragments are ignored without more errors
+      const bool dropped = (_assembly_received > 0);
+      _assembly_length = 0;
+      _assembly_received = 0;
+      if (dropped && _error_callback != nullptr)
+      {
+        _error_callback(MESSAGE_FORMAT);
+      }
+      return;
     }
-    else
+    if (total > REASSEMBLY_LENGTH || (uint32_t)offset + n > total)
     {
-      // otherwise, just send the character
-      _com->write(value);
+      _assembly_length = 0;
+      _assembly_received = 0;
+      if (_error_callback != nullptr)
+      {
+        _error_callback(MAX_LENGTH_EXCEEDED);
+      }
+      return;
+    }
+    memcpy(&_assembly[offset], &_message[FRAGMENT_HEADER], n);
+    _assembly_crc.update(&_message[FRAGMENT_HEADER], n);
+    _assembly_received += n;
+    if (_assembly_received == _assembly_length)
+    {
+      // append the checksum, so the message looks like one large frame
+      const uint32_t checksum = _assembly_crc.value();
+      write(&_assembly[_assembly_length], checksum);
+      _assembled = true;
+      if (_rx_callback != nullptr)
+      {
+        _rx_callback(_assembly_length + 4);
+      }
+      _assembled = false;
+      _assembly_length = 0;
+      _assembly_received = 0;
     }
   }
+#if BINARY_SERIAL_TX_QUEUE > 0
+  /*!
+  * @brief start writing the next waiting frame, priority lane first
+  * @return false if no frame is waiting
+  */
+  bool startFrame()
+  {
+    _tx_lane = !_tx_lanes[1].lengths.isEmpty() ? &_tx_lanes[1] : &_tx_lanes[0];
+    uint16_t length;
+    if (_tx_lane->lengths.takeBack(&length) != 0)
+    {
+      return false;
+    }
+    _tx_remaining = length;
+    return true;
+  }
+#endif
 
-public:
-  BinarySerial(Stream &s) : _com(&s) {}
-
-  void setMessageReceivedCallback(intCallback c) { _rx_callback = c; }
-  void setMessageSentCallback(intCallback c) { _tx_callback = c; }
-  void setMessageErrorCallback(intCallback c) { _error_callback = c; }
+  /*!
+  * @brief write a block of an escaped frame to the stream, or to the
+  * transmit lane if the frame is being queued
+  */
+  void output(const uint8_t *block, const uint16_t n)
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    if (_tx_target != nullptr)
+    {
+      _tx_target->bytes.putN(block, n);
+      return;
+    }
+#endif
+    _com->write(block, n);
+  }
 
   /*!
-  * @brief Access the buffer containing most recently received message
-  * This data is only valid in the callback function. Message data will
-  * be overwritten as new data is received
-  * @return a pointer to the first byte in the message buffer
+  * @return the number of bytes in data after SLIP encoding
   */
-  uint8_t* messageData() { return _message; }
+  uint32_t encodedLength(const uint8_t *data, uint16_t len) const
+  {
+    uint32_t n = len;
+    while (len--)
+    {
+      const uint8_t value = *data++;
+      n += (value == END || value == ESC);
+    }
+    return n;
+  }
 
   /*!
-  * @brief The number of bytes in the current message
-  * @return the number of bytes in the message buffer.
-  * Bytes from index 0 to messageLength() - 1 are valid data.
+  * @brief SLIP encode bytes into the transmit block. The block is written to
+  * the stream (or queued) whenever it fills.
+  * @param block the transmit block of BINARY_SERIAL_TX_BLOCK bytes
+  * @param n the number of bytes in the block
+  * @param data the bytes to encode
+  * @param len the number of bytes to encode
   */
-  uint8_t messageLength() const { return _msg_idx; }
+  void encode(uint8_t *block, uint16_t &n, const uint8_t *data, uint16_t len)
+  {
+    while (len--)
+    {
+      // room for an escaped pair
+      if (n > BINARY_SERIAL_TX_BLOCK - 2)
+      {
+        output(block, n);
+        n = 0;
+      }
+      const uint8_t value = *data++;
+      if (value == END)
+      {
+        // send a special two character code so as not to make the
+        // receiver think we sent an END
+        block[n++] = ESC;
+        block[n++] = ESC_END;
+      }
+      else if (value == ESC)
+      {
+        block[n++] = ESC;
+        block[n++] = ESC_ESC;
+      }
+      else
+      {
+        block[n++] = value;
+      }
+    }
+  }
 
   /*!
-  * @brief send a packet
-  * @param the address of the first byte the send
-  * @param the number of bytes to send
+  * @brief COBS encode the parts of a packet as one message into the transmit
+  * block. Each block of the encoding is a code byte, one more than the
+  * number of non-zero bytes that follow it. A code below 0xFF also stands
+  * for the zero that ended the run.
+  * @param block the transmit block of BINARY_SERIAL_TX_BLOCK bytes, or
+  * nullptr to only count the encoded bytes
+  * @param n the number of bytes in the block
+  * @param parts the address of the first byte of each part
+  * @param lengths the number of bytes in each part
+  * @param n_parts the number of parts
+  * @return the number of encoded bytes
   */
-  void sendPacket(uint8_t *packet, uint8_t len)
+  uint32_t encodeCobs(uint8_t *block, uint16_t &n, const uint8_t *const *parts, const uint16_t *lengths, const uint8_t n_parts)
   {
-    // calculate a checksum for the packet
-    uint32_t checksum = crc32(packet, len);
+    uint32_t count = 0;
+    uint8_t part = 0;
+    uint16_t pos = 0;
+    for (;;)
+    {
+      // find the run of non-zero bytes from the cursor
+      uint8_t end_part = part;
+      uint16_t end_pos = pos;
+      uint8_t run = 0;
+      bool zero = false;
+      while (run < 0xFE)
+      {
+        while (end_part < n_parts && end_pos >= lengths[end_part])
+        {
+          end_part++;
+          end_pos = 0;
+        }
+        if (end_part == n_parts)
+        {
+          break;
+        }
+        if (parts[end_part][end_pos] == 0)
+        {
+          zero = true;
+          break;
+        }
+        run++;
+        end_pos++;
+      }
+      count += run + 1;
+      if (block != nullptr)
+      {
+        if (n > BINARY_SERIAL_TX_BLOCK - 1)
+        {
+          output(block, n);
+          n = 0;
+        }
+        block[n++] = run + 1;
+        while (run > 0)
+        {
+          while (pos >= lengths[part])
+          {
+            part++;
+            pos = 0;
+          }
+          // copy as much of the run from this part as fits in the block
+          uint16_t k = lengths[part] - pos;
+          if (k > run)
+          {
+            k = run;
+          }
+          if (n >= BINARY_SERIAL_TX_BLOCK)
+          {
+            output(block, n);
+            n = 0;
+          }
+          if (k > BINARY_SERIAL_TX_BLOCK - n)
+          {
+            k = BINARY_SERIAL_TX_BLOCK - n;
+          }
+          memcpy(&block[n], &parts[part][pos], k);
+          n += k;
+          pos += k;
+          run -= k;
+        }
+      }
+      part = end_part;
+      pos = end_pos;
+      if (zero)
+      {
+        // the zero is implied by the code, skip it
+        pos++;
+        continue;
+      }
+      // a full block does not imply a zero, so it ends the message
+      // only if no data follows it
+      while (part < n_parts && pos >= lengths[part])
+      {
+        part++;
+        pos = 0;
+      }
+      if (part == n_parts)
+      {
+        return count;
+      }
+    }
+  }
 
-    // send an END character to flush out any data that may
-    // have accumulated in the receiver due to line noise
-    _com->write(END);
+  /*!
+  * @brief store a decoded byte in the message buffer
+  * @param idx the number of bytes in the buffer
+  * @param crc the CRC register, updated with the byte that is no longer
+  * one of the last four
+  */
+  void store(uint16_t &idx, uint32_t &crc, const uint8_t value)
+  {
+    if (idx < MESSAGE_LENGTH)
+    {
+      // the last four bytes may be the checksum, so a byte is added
+      // to the crc when it is four bytes from the end
+      if (idx >= 4)
+      {
+        crc = LT::CRC32::step(crc, _message[idx - 4]);
+      }
+      _message[idx++] = value;
+    }
+    else
+    {
+      // max packet length exceeded
+      idx = 0; // start writing data to the beginning of the buffer again
+      crc = 0xFFFFFFFF;
+      if (_error_callback != nullptr)
+      {
+        _error_callback(MAX_LENGTH_EXCEEDED);
+      }
+    }
+  }
 
-    // for each byte in the packet, send the appropriate character sequence
-    for (uint8_t i = 0; i < len; ++i)
+  /*!
+  * @brief handle the message once its end delimiter is received
+  */
+  void endMessage(uint16_t &idx, uint32_t &crc)
+  {
+    if (idx)
     {
-      encode(*packet++);
+      _msg_idx = idx;
+      _rx_crc = crc;
+      handleMessage();
+      idx = _msg_idx;
+      crc = _rx_crc;
     }
-    // send a four byte checksum
-    uint8_t *p = (uint8_t *)&checksum;
-    encode(p[0]);
-    encode(p[1]);
-    encode(p[2]);
-    encode(p[3]);
-    // tell the receiver the packet is done
-    _com->write(END);
   }
 
   /*!
-  * @brief checks the communication stream for new data. If data can be read,
-  * it is decoded and stored in the incoming message buffer. When an unescaped
-  * END byte is recieved, the message is handled.
+  * @brief decode a block of received SLIP data
   */
-  void update()
+  void receiveSlip(const uint8_t *data, uint16_t len)
   {
-    // check for rx data
-    if (_com->available())
+    uint16_t idx = _msg_idx;
+    bool escaped = _escaped;
+    uint32_t crc = _rx_crc;
+    while (len--)
     {
-      uint8_t next_byte = _com->read();
-      //Serial.print("got byte: ");
-      //Serial.print(next_byte, HEX);
-      //Serial.println("!");
-      if (_escaped)
+      uint8_t next_byte = *data++;
+      if (escaped)
       {
         // handle escaped condition
         // if the byte is not one of these, there is
@@ -195,52 +503,439 @@ public:
         {
           next_byte = ESC;
         }
-        else 
+        else if (_error_callback != nullptr)
         {
-          // don't modify next_byte
-          // send error message
-          if (_error_callback != nullptr)
-          {
-            (*_error_callback)(SLIP_VIOLATION);
-          }
+          _error_callback(SLIP_VIOLATION);
         }
-        _escaped = false;
+        escaped = false;
       }
-
       else if (next_byte == END)
       {
         // if it's an END character then we're done with the packet
-        if (_msg_idx)
-        {
-          handleMessage();
-          return;
-        }
-        else
-        {
-          return;
-        }
+        endMessage(idx, crc);
+        continue;
       }
       else if (next_byte == ESC)
       {
         // if it's an ESC character, set escaped flag and wait
         // for another character
-        _escaped = true;
-        return;
+        escaped = true;
+        continue;
       }
       // finally, store the character in the message buffer
-      if (_msg_idx < MAX_MESSAGE_LENGTH)
+      store(idx, crc, next_byte);
+    }
+    _msg_idx = idx;
+    _escaped = escaped;
+    _rx_crc = crc;
+  }
+
+  /*!
+  * @brief decode a block of received COBS data. The message is decoded
+  * in place as it arrives, so no second buffer is needed
+  */
+  void receiveCobs(const uint8_t *data, uint16_t len)
+  {
+    uint16_t idx = _msg_idx;
+    uint32_t crc = _rx_crc;
+    uint8_t code = _cobs_code;
+    uint8_t remaining = _cobs_remaining;
+    while (len--)
+    {
+      const uint8_t next_byte = *data++;
+      if (next_byte == 0)
+      {
+        // a delimiter ends the message. A message cut short by a
+        // delimiter fails its checksum
+        endMessage(idx, crc);
+        code = 0;
+        remaining = 0;
+      }
+      else if (remaining > 0)
       {
-        _message[_msg_idx++] = next_byte;
+        store(idx, crc, next_byte);
+        remaining--;
       }
       else
       {
-        // max packet length exceeded
-        _msg_idx = 0; // start writing data to the beginning of the buffer again
-        if (_error_callback != nullptr)
+        // a code byte. The block before it ended with a zero,
+        // unless it was the first block or a full one
+        if (code != 0 && code != 0xFF)
+        {
+          store(idx, crc, 0);
+        }
+        code = next_byte;
+        remaining = next_byte - 1;
+      }
+    }
+    _msg_idx = idx;
+    _rx_crc = crc;
+    _cobs_code = code;
+    _cobs_remaining = remaining;
+  }
+
+public:
+  BasicBinarySerial(Stream &s) : _com(&s)
+  {
+    static_assert(MESSAGE_LENGTH > 4, "BinarySerial messages need room for the checksum");
+  }
+
+  void setMessageReceivedCallback(LT::Delegate<void(int)> c) { _rx_callback = c; }
+  void setMessageSentCallback(LT::Delegate<void(int)> c) { _tx_callback = c; }
+  void setMessageErrorCallback(LT::Delegate<void(int)> c) { _error_callback = c; }
+
+  /*!
+  * @brief Access the buffer containing most recently received message
+  * This data is only valid in the callback function. Message data will
+  * be overwritten as new data is received
+  * @return a pointer to the first byte in the message buffer, or the
+  * reassembly buffer for a fragmented message
+  */
+  uint8_t* messageData() { return _assembled ? _assembly : _message; }
+
+  /*!
+  * @brief The number of bytes in the current message
+  * @return the number of bytes in the message buffer.
+  * Bytes from index 0 to messageLength() - 1 are valid data.
+  */
+  uint16_t messageLength() const { return _assembled ? _assembly_length + 4 : _msg_idx; }
+
+  /*!
+  * @brief read the current message with a bounds checked cursor. Only valid
+  * in the message received callback, like messageData()
+  * @return a reader over the message after its function code, without
+  * the checksum
+  */
+  LT::PayloadReader payload()
+  {
+    const uint16_t length = messageLength();
+    return LT::PayloadReader(messageData() + 1, (length > 5) ? length - 5 : 0);
+  }
+
+  /*!
+  * @return the size of the incoming message buffer, including the checksum
+  */
+  uint16_t maxMessageLength() const { return MESSAGE_LENGTH; }
+
+  /*!
+  * @brief send a packet
+  * @param the address of the first byte the send
+  * @param the number of bytes to send
+  * @return int8_t 0 on success, -1 if the packet was dropped because the
+  * transmit queue was full
+  */
+  int8_t sendPacket(const uint8_t *packet, uint16_t len)
+  {
+    return sendPacket(nullptr, 0, packet, len);
+  }
+
+  /*!
+  * @brief send the bytes written to a PayloadWriter or Packet
+  * @return int8_t 0 on success, -1 if a write did not fit in the writer
+  * or the packet was dropped because the transmit queue was full
+  */
+  int8_t sendPacket(const LT::PayloadWriter &packet)
+  {
+    if (!packet.ok())
+    {
+      return -1;
+    }
+    return sendPacket(packet.data(), packet.length());
+  }
+
+  /*!
+  * @brief send a packet made of a header followed by a payload, without
+  * copying them into one buffer first.
+  *
+  * With the transmit queue, the frame is written at once if the stream has
+  * room and nothing is waiting. Otherwise it is queued and written by
+  * update() as room becomes available. Acknowledge and Error packets, and
+  * packets sent with priority, use the priority lane, which is written
+  * before any other waiting frame. The packet type is the first header
+  * byte, so a header that is not a function code needs priority set.
+  * A frame longer than a lane (BINARY_SERIAL_TX_QUEUE bytes) can not be
+  * queued: the waiting frames and then the frame are written directly,
+  * and the call blocks until the stream has taken them.
+  *
+  * @param header the address of the first header byte
+  * @param header_len the number of header bytes
+  * @param payload the address of the first payload byte
+  * @param payload_len the number of payload bytes
+  * @param priority true to queue the frame in the priority lane
+  * @return int8_t 0 on success, -1 if the packet was dropped because the
+  * transmit queue was full
+  */
+  int8_t sendPacket(const uint8_t *header, uint8_t header_len, const uint8_t *payload, uint16_t payload_len, const bool priority = false)
+  {
+    // calculate a checksum for the packet
+    uint32_t checksum = crc32(header, header_len);
+    checksum = crc32(payload, payload_len, checksum);
+
+    const uint8_t *parts[3] = {header, payload, (const uint8_t *)&checksum};
+    const uint16_t lengths[3] = {header_len, payload_len, 4};
+    uint16_t n = 0;
+
+#if BINARY_SERIAL_TX_QUEUE > 0
+    const uint32_t frame_length = 2 + ((FRAMING == LT::Framing_COBS) ?
+      encodeCobs(nullptr, n, parts, lengths, 3) :
+      encodedLength(header, header_len) + encodedLength(payload, payload_len) + encodedLength(parts[2], 4));
+    const bool waiting = (_tx_remaining > 0 || !_tx_lanes[0].lengths.isEmpty() || !_tx_lanes[1].lengths.isEmpty());
+    if (_tx_queue_enabled && frame_length > BINARY_SERIAL_TX_QUEUE)
+    {
+      // the frame can never fit in a lane. Write it directly after
+      // the waiting frames, as without the queue
+      drain();
+    }
+    else if (_tx_queue_enabled && (waiting || (uint32_t)_com->availableForWrite() < frame_length))
+    {
+      const uint8_t code = (header_len > 0) ? header[0] : ((payload_len > 0) ? payload[0] : 0);
+      TxLane &lane = _tx_lanes[(priority || code == LT::Acknowledge || code == LT::Error) ? 1 : 0];
+      if (lane.lengths.isFull() || (uint32_t)(lane.bytes.size() - lane.bytes.count()) < frame_length)
+      {
+        _tx_dropped++;
+        return -1;
+      }
+      lane.lengths.put(frame_length);
+      _tx_target = &lane;
+    }
+#else
+    (void)priority;
+#endif
+
+    // the frame is escaped into a block and written with as few
+    // write() calls as possible. Frames that fit are written at once
+    uint8_t block[BINARY_SERIAL_TX_BLOCK];
+    // send a delimiter to flush out any data that may
+    // have accumulated in the receiver due to line noise
+    const uint8_t delimiter = (FRAMING == LT::Framing_COBS) ? 0 : END;
+    block[n++] = delimiter;
+    if (FRAMING == LT::Framing_COBS)
+    {
+      encodeCobs(block, n, parts, lengths, 3);
+    }
+    else
+    {
+      encode(block, n, header, header_len);
+      encode(block, n, payload, payload_len);
+      // send a four byte checksum
+      encode(block, n, parts[2], 4);
+    }
+    // tell the receiver the packet is done
+    if (n >= BINARY_SERIAL_TX_BLOCK)
+    {
+      output(block, n);
+      n = 0;
+    }
+    block[n++] = delimiter;
+    output(block, n);
+
+#if BINARY_SERIAL_TX_QUEUE > 0
+    if (_tx_target != nullptr)
+    {
+      _tx_target = nullptr;
+      flush();
+    }
+#endif
+    return 0;
+  }
+
+  /*!
+  * @brief send a message of any length as a series of Fragment packets.
+  * The receiver must have a reassembly buffer of at least len bytes
+  * @param packet the address of the first byte of the message
+  * @param len the number of bytes in the message
+  * @param fragment_length the most message bytes per fragment. The default
+  * fills a receive buffer of the same size as this one
+  * @return int8_t 0 on success, -1 if a fragment was dropped because the
+  * transmit queue was full
+  */
+  int8_t sendFragmented(const uint8_t *packet, const uint16_t len,
+    const uint16_t fragment_length = MESSAGE_LENGTH - 4 - FRAGMENT_HEADER)
+  {
+    if (fragment_length == 0)
+    {
+      return -1;
+    }
+    LT::Packet<FRAGMENT_HEADER> header;
+    uint16_t offset = 0;
+    do
+    {
+      const uint16_t n = (len - offset < fragment_length) ? (len - offset) : fragment_length;
+      header.clear();
+      header.write(LT::Fragment).write(offset).write(len);
+      if (sendPacket(header.data(), FRAGMENT_HEADER, packet + offset, n) != 0)
+      {
+        return -1;
+      }
+      offset += n;
+    } while (offset < len);
+    return 0;
+  }
+
+  /*!
+  * @brief Enable or disable the transmit queue. The queue needs a stream
+  * that reports its free space with availableForWrite(). Disable it for
+  * streams that always return 0, such as SoftwareSerial
+  * @param enabled false to always write packets directly, which can block
+  */
+  void setTransmitQueue(const bool enabled)
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    _tx_queue_enabled = enabled;
+#endif
+  }
+
+  /*!
+  * @brief write as much of the transmit queue as the stream has room for,
+  * without blocking. Called by update()
+  */
+  void flush()
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    uint8_t block[BINARY_SERIAL_TX_BLOCK];
+    int room = _com->availableForWrite();
+    while (room > 0)
+    {
+      if (_tx_remaining == 0 && !startFrame())
+      {
+        return;
+      }
+      uint16_t n = _tx_remaining;
+      if (n > (uint16_t)room)
+      {
+        n = room;
+      }
+      if (n > BINARY_SERIAL_TX_BLOCK)
+      {
+        n = BINARY_SERIAL_TX_BLOCK;
+      }
+      n = _tx_lane->bytes.takeN(block, n);
+      _com->write(block, n);
+      _tx_remaining -= n;
+      room -= n;
+    }
+#endif
+  }
+
+  /*!
+  * @brief write the whole transmit queue, blocking until the stream has
+  * taken it
+  */
+  void drain()
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    uint8_t block[BINARY_SERIAL_TX_BLOCK];
+    for (;;)
+    {
+      if (_tx_remaining == 0 && !startFrame())
+      {
+        return;
+      }
+      const uint16_t n = _tx_lane->bytes.takeN(block, (_tx_remaining > BINARY_SERIAL_TX_BLOCK) ? BINARY_SERIAL_TX_BLOCK : _tx_remaining);
+      _com->write(block, n);
+      _tx_remaining -= n;
+    }
+#endif
+  }
+
+  /*!
+  * @return the number of bytes waiting in the transmit queue
+  */
+  uint16_t pendingBytes() const
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    return _tx_lanes[0].bytes.count() + _tx_lanes[1].bytes.count();
+#else
+    return 0;
+#endif
+  }
+
+  /*!
+  * @return the number of packets dropped because the transmit queue was full
+  */
+  uint16_t droppedPackets() const
+  {
+#if BINARY_SERIAL_TX_QUEUE > 0
+    return _tx_dropped;
+#else
+    return 0;
+#endif
+  }
+
+  /*!
+  * @brief Limit the work done by each call to update(). By default all
+  * available bytes are read.
+  * @param max_bytes the most bytes to read per update, 0 for no limit
+  * @param max_us the most time in microseconds to spend reading per update,
+  * checked after each block of BINARY_SERIAL_RX_BLOCK bytes. 0 for no limit
+  */
+  void setReceiveBudget(const uint16_t max_bytes, const uint32_t max_us = 0)
+  {
+    _rx_budget = max_bytes;
+    _rx_time_budget_us = max_us;
+  }
+
+  /*!
+  * @brief checks the communication stream for new data. Available data is
+  * read in blocks, decoded and stored in the incoming message buffer, up to
+  * the receive budget. Each time a frame delimiter is recieved,
+  * the message is handled.
+  */
+  void update()
+  {
+    flush();
+    uint8_t block[BINARY_SERIAL_RX_BLOCK];
+    uint16_t budget = _rx_budget;
+    const uint32_t t_start = micros();
+    int n;
+    while ((n = _com->available()) > 0)
+    {
+      if (n > BINARY_SERIAL_RX_BLOCK)
+      {
+        n = BINARY_SERIAL_RX_BLOCK;
+      }
+      if (_rx_budget)
+      {
+        if (budget == 0)
+        {
+          return;
+        }
+        if (n > budget)
         {
-          (*_error_callback)(MAX_LENGTH_EXCEEDED);
+          n = budget;
         }
+        budget -= n;
       }
+      // no more than available() is requested, so readBytes() does not wait
+      n = _com->readBytes(block, n);
+      if (n <= 0)
+      {
+        return;
+      }
+      receive(block, n);
+      if (_rx_time_budget_us && (micros() - t_start) >= _rx_time_budget_us)
+      {
+        return;
+      }
+    }
+  }
+
+  /*!
+  * @brief decode a block of received data. update() calls this with the
+  * data read from the stream. It can also be called directly with data
+  * from another source.
+  * @param data the received bytes
+  * @param len the number of bytes
+  */
+  void receive(const uint8_t *data, uint16_t len)
+  {
+    if (FRAMING == LT::Framing_COBS)
+    {
+      receiveCobs(data, len);
+    }
+    else
+    {
+      receiveSlip(data, len);
     }
   }
   
@@ -253,13 +948,8 @@ public:
   template <typename T>
   uint8_t write(uint8_t *packet, const T &value)
   {
-    const uint8_t *p = (const uint8_t *)&value;
-    uint8_t i;
-    for (i = 0; i < sizeof(value); ++i)
-    {
-      packet[i] = p[i];
-    }
-    return i;
+    memcpy(packet, &value, sizeof(value));
+    return sizeof(value);
   }
 
   /*!
@@ -269,9 +959,10 @@ public:
   * @return the number of bytes read
   */
   template <typename T>
-  uint8_t read(uint8_t *packet, T &value)
+  uint8_t read(const uint8_t *packet, T &value)
   {
-    value = *(T *)(packet);
+    // packet may not be aligned for T
+    memcpy(&value, packet, sizeof(value));
     return sizeof(value);
   }
 
@@ -283,8 +974,9 @@ public:
    */
   void sendAcknowledge(const LT::FN_CODE code)
   {
-    uint8_t packet[2] = {LT::Acknowledge, code};
-    sendPacket(packet, 2);
+    LT::Packet<2> packet;
+    packet.write(LT::Acknowledge).write(code);
+    sendPacket(packet);
   }
 
   /*!
@@ -296,8 +988,9 @@ public:
    */
   void sendError(LT::FN_CODE code)
   {
-    uint8_t packet[] = {LT::Error, code};
-    sendPacket(packet, 2);
+    LT::Packet<2> packet;
+    packet.write(LT::Error).write(code);
+    sendPacket(packet);
   }
 
   /*!
@@ -308,14 +1001,11 @@ public:
   */
   void sendError(uint8_t *codes, uint8_t len)
   {
-    uint8_t packet[1 + len];
-    packet[0] = LT::Error;
-    for (uint8_t i = 0; i < len; ++i)
-    {
-      packet[i + 1] = codes[i];
-    }
-    sendPacket(packet, len + 1);
+    uint8_t header = LT::Error;
+    sendPacket(&header, 1, codes, len);
   }
 };
 
+typedef BasicBinarySerial<BINARY_SERIAL_MESSAGE_LENGTH> BinarySerial;
+
 #endif //End __BINARY_SERIAL_H__ include guard
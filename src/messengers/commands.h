@@ -35,7 +35,7 @@ namespace LT {
     Read_Setting          = 0x17, // (23) Read a setting of a motor
     // (24) reserved
     // (25) reserved
-    // (26) reserved
+    Motion_Queue_Info     = 0x1A, // (26) Read the number of queued and available motion segments of a motor
     Go_To                 = 0x1B, // (27) Go to a process step in the queue
     Enqueue               = 0x1C, // (28) Add a function to the queue
     Read_From_Queue       = 0x1D, // (29) Read a functions from the queue
@@ -46,7 +46,7 @@ namespace LT {
     Reset_Process         = 0x22, // (34) Reset a process
     Interrupt_Process     = 0x23, // (35) Pause and interrupt the current process
     Process_Info          = 0x24, // (36) Request information about a process step
-    // (37) reserved
+    Fragment              = 0x25, // (37) A piece of a message that is too large for one packet
     Time_Sync             = 0x26, // (38) Send clock sync time
     Time_Followup         = 0x27, // (39) Send clock sync response time
     Delay_Request         = 0x28, // (40) Request transmission delay time
@@ -2,6 +2,7 @@
 #define __MESSAGE_HANDLER_H__
 
 #include "commands.h"
+#include "../utilities/delegate.h"
 
 //extern "C" {
 // callback functions always follow the signature: void cmd(void);
@@ -31,10 +32,10 @@ typedef void(*func_ptr) (void* sender);
  */
 class MessageHandler {
 
-    //< a vector to store pointers to attached callback functions
-    func_ptr _function_list[MAX_FUNCTIONS] = { nullptr };
-    //< a pointer to a default callback function
-    func_ptr _default_function = nullptr;
+    //< a vector to store attached callback functions
+    LT::Delegate<void(void*)> _function_list[MAX_FUNCTIONS];
+    //< a default callback function
+    LT::Delegate<void(void*)> _default_function;
   
   public:
     /*!
@@ -63,8 +64,8 @@ class MessageHandler {
     }
 
     /*!
-     * @brief attachFunction stores a function pointer func_ptr
-     * at the index id of the function pointer array. If there is
+     * @brief attachFunction stores a callback (a function or an
+     * LT::Delegate bound to an object) at the index id of the callback array. If there is
      * already a function at the index, it is replaced.
      * 
      * example: to call the function checkSensor() when the function code
@@ -74,7 +75,7 @@ class MessageHandler {
      * @param id the function code to assign to the callback
      * @param f the callback function
      */
-    void attachFunction( const uint8_t id, func_ptr f ) {
+    void attachFunction( const uint8_t id, LT::Delegate<void(void*)> f ) {
       if (id >= 0 && id < MAX_FUNCTIONS) {
         _function_list[id] = f;
       }
@@ -87,7 +88,7 @@ class MessageHandler {
      * 
      * @param f 
      */
-    void attachDefaultFunction( func_ptr f ) {
+    void attachDefaultFunction( LT::Delegate<void(void*)> f ) {
       _default_function = f;
     }
     
@@ -0,0 +1,257 @@
+#ifndef __PAYLOAD_H__
+#define __PAYLOAD_H__
+
+#include <stdint.h>
+#include <string.h>
+
+/*!
+ * @file payload.h
+ *
+ * PayloadReader and PayloadWriter are cursors over a message buffer, so
+ * handlers do not count offsets or cast pointers by hand.
+ *
+ * Values are copied with memcpy(), so they can be at any offset on any
+ * board. Every access is bounds checked. A read or write that does not
+ * fit sets an error flag that stays set, returns 0 (or does nothing) and
+ * leaves the cursor where it was, so a handler can do all its reads and
+ * check ok() once at the end.
+ *
+ * read()/write() use little-endian byte order, the order of the BinarySerial
+ * protocol. readBE()/writeBE() are for big-endian fields. readStruct() and
+ * writeStruct() copy a packed struct as it is laid out in memory, which is
+ * a single memcpy().
+ *
+ * void onWriteSpeed(void*) {
+ *   LT::PayloadReader in = messenger.payload();
+ *   const uint8_t id = in.read<uint8_t>();
+ *   const float rpm = in.read<float>();
+ *   if( !in.ok() ) { messenger.sendError(LT::Write_Speed); return; }
+ *   ...
+ *   LT::Packet<6> out;
+ *   out.write(LT::Read_Speed).write(id).write(motor.getSpeed());
+ *   messenger.sendPacket(out);
+ * }
+ */
+
+namespace LT {
+  /*!
+   * @brief copy n bytes, reversing their order if the host byte order is
+   * not the wanted one. Resolved at compile time
+   */
+  template <bool LITTLE_ENDIAN_DATA>
+  inline void copyOrdered(uint8_t *dst, const uint8_t *src, const uint16_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const bool reverse = LITTLE_ENDIAN_DATA;
+#else
+    const bool reverse = !LITTLE_ENDIAN_DATA;
+#endif
+    if( reverse ) {
+      for( uint16_t i = 0; i < n; ++i ) {
+        dst[i] = src[n - 1 - i];
+      }
+    }
+    else {
+      memcpy(dst, src, n);
+    }
+  }
+
+  /*!
+   * @brief reads values from a received message
+   */
+  class PayloadReader {
+      const uint8_t *_data;
+      uint16_t _length;
+      uint16_t _position = 0;
+      bool _error = false;
+
+      template <bool LITTLE_ENDIAN_DATA, class T>
+      T get() {
+        T value;
+        const uint8_t *p = view(sizeof(T));
+        if( p == nullptr ) {
+          memset(&value, 0, sizeof(T));
+        }
+        else {
+          copyOrdered<LITTLE_ENDIAN_DATA>((uint8_t *)&value, p, sizeof(T));
+        }
+        return value;
+      }
+
+    public:
+      /*!
+       * @param data the first byte of the message
+       * @param length the number of bytes that can be read
+       */
+      PayloadReader(const uint8_t *data, const uint16_t length) : _data(data), _length(length) {}
+
+      /*!
+       * @brief read a little-endian value
+       */
+      template <class T>
+      T read() { return get<true, T>(); }
+
+      /*!
+       * @brief read a little-endian value into value
+       * @return PayloadReader& this reader, so reads can be chained
+       */
+      template <class T>
+      PayloadReader& read(T &value) {
+        value = get<true, T>();
+        return *this;
+      }
+
+      /*!
+       * @brief read a big-endian value
+       */
+      template <class T>
+      T readBE() { return get<false, T>(); }
+
+      /*!
+       * @brief copy a packed struct in memory order
+       */
+      template <class T>
+      PayloadReader& readStruct(T &value) {
+        return readBytes(&value, sizeof(T));
+      }
+
+      /*!
+       * @brief copy n bytes into dst
+       */
+      PayloadReader& readBytes(void *dst, const uint16_t n) {
+        const uint8_t *p = view(n);
+        if( p != nullptr ) {
+          memcpy(dst, p, n);
+        }
+        return *this;
+      }
+
+      /*!
+       * @brief get a pointer to the next n bytes in the message without
+       * copying them, and move past them
+       * @return the first byte, or nullptr if there are fewer than n bytes left
+       */
+      const uint8_t* view(const uint16_t n) {
+        if( _error || n > _length - _position ) {
+          _error = true;
+          return nullptr;
+        }
+        const uint8_t *p = _data + _position;
+        _position += n;
+        return p;
+      }
+
+      PayloadReader& skip(const uint16_t n) {
+        view(n);
+        return *this;
+      }
+
+      /*!
+       * @return true if every read so far was in bounds
+       */
+      bool ok() const { return !_error; }
+      uint16_t position() const { return _position; }
+      uint16_t remaining() const { return _length - _position; }
+      uint16_t length() const { return _length; }
+  };
+
+  /*!
+   * @brief writes values into a buffer to be sent
+   */
+  class PayloadWriter {
+      uint8_t *_data;
+      uint16_t _size;
+      uint16_t _length = 0;
+      bool _error = false;
+
+      template <bool LITTLE_ENDIAN_DATA, class T>
+      PayloadWriter& put(const T &value) {
+        uint8_t *p = reserve(sizeof(T));
+        if( p != nullptr ) {
+          copyOrdered<LITTLE_ENDIAN_DATA>(p, (const uint8_t *)&value, sizeof(T));
+        }
+        return *this;
+      }
+
+    public:
+      /*!
+       * @param data the buffer to write into
+       * @param size the size of the buffer
+       */
+      PayloadWriter(uint8_t *data, const uint16_t size) : _data(data), _size(size) {}
+
+      /*!
+       * @brief write a little-endian value
+       * @return PayloadWriter& this writer, so writes can be chained
+       */
+      template <class T>
+      PayloadWriter& write(const T &value) { return put<true>(value); }
+
+      /*!
+       * @brief write a big-endian value
+       */
+      template <class T>
+      PayloadWriter& writeBE(const T &value) { return put<false>(value); }
+
+      /*!
+       * @brief copy a packed struct in memory order
+       */
+      template <class T>
+      PayloadWriter& writeStruct(const T &value) {
+        return writeBytes(&value, sizeof(T));
+      }
+
+      PayloadWriter& writeBytes(const void *src, const uint16_t n) {
+        uint8_t *p = reserve(n);
+        if( p != nullptr ) {
+          memcpy(p, src, n);
+        }
+        return *this;
+      }
+
+      /*!
+       * @brief make room for n bytes to be filled in place, for example by
+       * a sensor driver reading straight into the message
+       * @return the first byte, or nullptr if there is not enough room
+       */
+      uint8_t* reserve(const uint16_t n) {
+        if( _error || n > _size - _length ) {
+          _error = true;
+          return nullptr;
+        }
+        uint8_t *p = _data + _length;
+        _length += n;
+        return p;
+      }
+
+      /*!
+       * @brief start again from an empty buffer
+       */
+      void clear() {
+        _length = 0;
+        _error = false;
+      }
+
+      /*!
+       * @return true if every write so far fitted in the buffer
+       */
+      bool ok() const { return !_error; }
+      const uint8_t* data() const { return _data; }
+      uint16_t length() const { return _length; }
+      uint16_t size() const { return _size; }
+  };
+
+  /*!
+   * @brief a PayloadWriter with its own buffer of N bytes
+   */
+  template <uint16_t N>
+  class Packet : public PayloadWriter {
+      uint8_t _buffer[N];
+
+    public:
+      Packet() : PayloadWriter(_buffer, N) {}
+      Packet(const Packet&) = delete;
+      Packet& operator=(const Packet&) = delete;
+  };
+}
+
+#endif //End __PAYLOAD_H__ include guard
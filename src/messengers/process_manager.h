@@ -2,6 +2,7 @@
 #define __MESSAGE_HANDLER_H__
 
 #include "../utilities/ring_buffer.h"
+#include "../utilities/delegate.h"
 
 typedef void (*intCallback)(int);
 
@@ -105,9 +106,9 @@ class ProcessManager {
   uint32_t _last_command_start_time = 0; ///< the system time in microseconds that the last command was started
   uint32_t _last_elapsed = 0;
 
-  intCallback _command_started_callback = nullptr;
-  intCallback _command_ended_callback = nullptr;
-  intCallback _process_ended_callback = nullptr;
+  LT::Delegate<void(int)> _command_started_callback;
+  LT::Delegate<void(int)> _command_ended_callback;
+  LT::Delegate<void(int)> _process_ended_callback;
 
 public:
   void update() {
@@ -196,15 +197,15 @@ public:
     return (LT_current_time_us - _last_command_start_time);
   }
 
-  void setCommandStartedCallback( intCallback f ) {
+  void setCommandStartedCallback( LT::Delegate<void(int)> f ) {
       _command_started_callback = f;
   }
 
-  void setCommandEndedCallback( intCallback f ) {
+  void setCommandEndedCallback( LT::Delegate<void(int)> f ) {
       _command_ended_callback = f;
   }
 
-  void setProcessEndedCallback( intCallback f ) {
+  void setProcessEndedCallback( LT::Delegate<void(int)> f ) {
       _process_ended_callback = f;
   }
 
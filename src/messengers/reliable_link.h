@@ -0,0 +1,297 @@
+#ifndef __RELIABLE_LINK_H__
+#define __RELIABLE_LINK_H__
+
+#include "binary_serial.h"
+
+/*!
+ * @file reliable_link.h
+ *
+ * ReliableLink adds sequence numbers, acknowledgements and retransmission
+ * to a BinarySerial messenger, so packets that are lost or corrupted on
+ * the cable are sent again instead of silently dropped.
+ *
+ * Every frame on the link starts with a 3 byte header:
+ * <flags><seq><ack><packet>
+ * flags: bit 0 set if the frame carries a packet, other bits 0
+ * seq: the 8-bit sequence number of the packet
+ * ack: the sequence number of the next packet the sender expects, which
+ * acknowledges every packet before it (a cumulative ACK)
+ *
+ * Up to WINDOW packets can be in flight before the first is acknowledged,
+ * so packets stream without waiting a round trip for each one. The
+ * receiver accepts packets only in order. A packet that is out of order
+ * is dropped and the last ACK repeated. When the oldest packet has not
+ * been acknowledged within the timeout, it and every packet after it are
+ * sent again (go-back-N), and the timeout doubles up to 8 times its
+ * setting until the link makes progress. An ACK on its own that does not
+ * acknowledge anything means the receiver dropped packets after a lost
+ * one, so the window is sent again at once, without waiting for the
+ * timeout. This happens once until the link makes progress.
+ *
+ * ACKs ride on outgoing packets. If no packet is sent, update() sends an
+ * ACK on its own, one for all the packets received since the last one.
+ * A lone ACK uses the priority lane of the messenger's transmit queue, so
+ * it is not held up behind bulk packets.
+ * Timing uses LT_current_time_us, so update() is called in the loop after
+ * DeviceManager::update(), like ProcessManager.
+ *
+ * Both ends of the messenger must use a ReliableLink: every frame carries
+ * the header. The sequence numbers start at 0, so when one end restarts,
+ * call reset() on the other, for example when the host opens the port.
+ *
+ * BinarySerial messenger(Serial);
+ * ReliableLink<BinarySerial> link(messenger);
+ * link.setMessageReceivedCallback(onMessage); // the same as messenger's, without the header
+ * ...
+ * messenger.update();
+ * link.update();
+ * if( link.available() ) link.sendPacket(data, len);
+ */
+
+/*!
+ * @tparam MESSENGER the BasicBinarySerial type of the messenger
+ * @tparam WINDOW the most packets in flight, a power of 2 (at most 128). Each waiting
+ * packet is kept for retransmission, so the link uses WINDOW * MAX_PACKET
+ * bytes of RAM
+ * @tparam MAX_PACKET the largest packet that can be sent. The default
+ * fills a default size BinarySerial frame at the receiver
+ */
+template <class MESSENGER, uint8_t WINDOW = 4, uint16_t MAX_PACKET = BINARY_SERIAL_MESSAGE_LENGTH - 4 - 3>
+class ReliableLink
+{
+  static const uint8_t HEADER = 3;     ///< flags, sequence number and ACK
+  static const uint8_t DATA = 0x01;    ///< the frame carries a packet
+  static const uint8_t MAX_BACKOFF = 3; ///< the timeout doubles at most 3 times
+
+  MESSENGER *_messenger;
+  LT::Delegate<void(int)> _rx_callback;
+
+  uint8_t _packets[WINDOW][MAX_PACKET]; ///< copies of the packets in flight, at their sequence number % WINDOW
+  uint16_t _lengths[WINDOW];
+  uint8_t _base = 0;      ///< the sequence number of the oldest packet in flight
+  uint8_t _next = 0;      ///< the sequence number of the next packet sent
+  uint8_t _expected = 0;  ///< the sequence number of the next packet to be received
+  bool _ack_pending = false; ///< a packet was received and not acknowledged yet
+
+  uint32_t _timeout_us;
+  uint32_t _t_base = 0;   ///< the system time in microseconds that the oldest packet was (re)sent
+  uint8_t _backoff = 0;   ///< the number of timeouts in a row
+  bool _fast_retransmitted = false; ///< the window was sent again for a repeated ACK, and not acknowledged since
+
+  uint16_t _retransmissions = 0; ///< packets sent again after a timeout
+  uint16_t _rejected = 0;        ///< received packets dropped as duplicates or out of order
+
+  uint8_t inFlight() const { return (uint8_t)(_next - _base); }
+
+  /*!
+  * @brief send every packet in flight again, oldest first
+  */
+  void retransmit()
+  {
+    for (uint8_t seq = _base; seq != _next; ++seq)
+    {
+      transmit(seq);
+      _retransmissions++;
+    }
+    _t_base = LT_current_time_us;
+  }
+
+  /*!
+  * @brief send a packet from the window with the current ACK. The
+  * messenger sees the header, not the function code, so Acknowledge and
+  * Error packets ask for its priority lane. They only get it when nothing
+  * is waiting, as the receiver accepts packets in order
+  */
+  int8_t transmit(const uint8_t seq)
+  {
+    const uint8_t slot = seq % WINDOW;
+    const uint8_t header[HEADER] = {DATA, seq, _expected};
+    const uint8_t code = (_lengths[slot] > 0) ? _packets[slot][0] : 0;
+    const bool priority = (code == LT::Acknowledge || code == LT::Error) && _messenger->pendingBytes() == 0;
+    const int8_t result = _messenger->sendPacket(header, HEADER, _packets[slot], _lengths[slot], priority);
+    // a dropped packet did not carry the ACK, so update() still sends it
+    if (result == 0)
+    {
+      _ack_pending = false;
+    }
+    return result;
+  }
+
+  /*!
+  * @brief send the ACK on its own. It has no sequence number, so it goes
+  * in the messenger's priority lane, ahead of queued packets
+  */
+  void sendAck()
+  {
+    const uint8_t header[HEADER] = {0, 0, _expected};
+    if (_messenger->sendPacket(header, HEADER, nullptr, 0, true) == 0)
+    {
+      _ack_pending = false;
+    }
+  }
+
+  /*!
+  * @brief the message received callback of the messenger
+  */
+  void onFrame(int n)
+  {
+    const uint8_t *frame = _messenger->messageData();
+    if (n < HEADER + 4)
+    {
+      return;
+    }
+    const uint8_t flags = frame[0];
+    const uint8_t seq = frame[1];
+
+    // the ACK releases every packet before it
+    const uint8_t acked = frame[2] - _base;
+    if (acked > 0 && acked <= inFlight())
+    {
+      _base += acked;
+      _backoff = 0;
+      _fast_retransmitted = false;
+      _t_base = LT_current_time_us;
+    }
+
+    if (!(flags & DATA))
+    {
+      // a lone ACK is only sent in reply to packets. If it does not
+      // acknowledge anything, the packets were out of order
+      if (acked == 0 && inFlight() > 0 && !_fast_retransmitted)
+      {
+        _fast_retransmitted = true;
+        retransmit();
+      }
+      return;
+    }
+    _ack_pending = true;
+    if (seq != _expected)
+    {
+      _rejected++;
+      return;
+    }
+    _expected++;
+    if (_rx_callback != nullptr)
+    {
+      _rx_callback(n - HEADER);
+    }
+  }
+
+public:
+  /*!
+  * @param messenger the messenger to send and receive frames with. Its
+  * message received callback is replaced by the link
+  * @param timeout_us the time to wait for an ACK before sending a packet
+  * again. It should be longer than a round trip of a full window
+  */
+  ReliableLink(MESSENGER &messenger, const uint32_t timeout_us = 100000)
+  : _messenger(&messenger), _timeout_us(timeout_us)
+  {
+    static_assert(WINDOW > 0 && WINDOW <= 128 && (WINDOW & (WINDOW - 1)) == 0,
+      "ReliableLink window must be a power of 2, at most 128");
+    _messenger->setMessageReceivedCallback(LT::Delegate<void(int)>::template member<ReliableLink, &ReliableLink::onFrame>(this));
+  }
+
+  /*!
+  * @brief called with the length of each packet that is received in order,
+  * plus 4 for the checksum, as for BinarySerial
+  */
+  void setMessageReceivedCallback(LT::Delegate<void(int)> c) { _rx_callback = c; }
+
+  void setTimeout(const uint32_t timeout_us) { _timeout_us = timeout_us; }
+
+  /*!
+  * @brief Access the packet being received. Only valid in the callback
+  * @return a pointer to the first byte of the packet, after the link header
+  */
+  uint8_t* messageData() { return _messenger->messageData() + HEADER; }
+
+  /*!
+  * @return a reader over the packet after its function code, as
+  * BinarySerial::payload()
+  */
+  LT::PayloadReader payload()
+  {
+    const uint16_t length = _messenger->messageLength();
+    return LT::PayloadReader(messageData() + 1, (length > HEADER + 5) ? length - HEADER - 5 : 0);
+  }
+
+  /*!
+  * @brief send a packet, and keep it until it is acknowledged
+  * @return int8_t 0 if the packet is in flight, -1 if the window is full
+  * or the packet is larger than MAX_PACKET
+  */
+  int8_t sendPacket(const uint8_t *packet, const uint16_t len)
+  {
+    if (inFlight() >= WINDOW || len > MAX_PACKET)
+    {
+      return -1;
+    }
+    const uint8_t seq = _next++;
+    const uint8_t slot = seq % WINDOW;
+    memcpy(_packets[slot], packet, len);
+    _lengths[slot] = len;
+    if (seq == _base)
+    {
+      _t_base = LT_current_time_us;
+    }
+    // a packet that the messenger could not queue is sent again on timeout
+    transmit(seq);
+    return 0;
+  }
+
+  int8_t sendPacket(const LT::PayloadWriter &packet)
+  {
+    if (!packet.ok())
+    {
+      return -1;
+    }
+    return sendPacket(packet.data(), packet.length());
+  }
+
+  /*!
+  * @brief send the ACK for received packets and resend packets that timed out
+  */
+  void update()
+  {
+    if (_ack_pending)
+    {
+      sendAck();
+    }
+    if (inFlight() > 0 && (LT_current_time_us - _t_base) >= (_timeout_us << _backoff))
+    {
+      retransmit();
+      if (_backoff < MAX_BACKOFF)
+      {
+        _backoff++;
+      }
+    }
+  }
+
+  /*!
+  * @brief forget the packets in flight and start the sequence numbers
+  * again. Both ends must be reset together
+  */
+  void reset()
+  {
+    _base = _next = _expected = 0;
+    _ack_pending = false;
+    _backoff = 0;
+    _fast_retransmitted = false;
+  }
+
+  /*!
+  * @return the number of packets that can be sent before the window is full
+  */
+  uint8_t available() const { return WINDOW - inFlight(); }
+
+  /*!
+  * @return the number of packets sent and not acknowledged yet
+  */
+  uint8_t pending() const { return inFlight(); }
+
+  uint16_t retransmissions() const { return _retransmissions; }
+  uint16_t rejected() const { return _rejected; }
+};
+
+#endif //End __RELIABLE_LINK_H__ include guard
@@ -0,0 +1,219 @@
+#ifndef __SCHEMA_H__
+#define __SCHEMA_H__
+
+#include "payload.h"
+#include "commands.h"
+
+/*!
+ * @file schema.h
+ *
+ * Message schemas declare the fields of each function code once, and
+ * generate the code that packs and unpacks them on the device and on a
+ * PC. This header only needs <stdint.h> and <string.h>, so a host program
+ * can include it together with the sketch's schema definitions.
+ *
+ * typedef LT::Message<LT::Write_Position,
+ *   LT::Schema<uint8_t, float>,   // request: motor id, position
+ *   LT::Schema<uint8_t, float>    // response: motor id, position reached
+ * > WritePosition;
+ *
+ * Device:
+ * uint8_t id; float position;
+ * if( WritePosition::decodeRequest(messenger.payload(), id, position) ) { ... }
+ * WritePosition::sendResponse(messenger, id, motor.getPosition());
+ *
+ * Host:
+ * LT::Packet<WritePosition::REQUEST_LENGTH> out;
+ * WritePosition::encodeRequest(out, 3, -101.5f);
+ * ...
+ * WritePosition::decodeResponse(LT::PayloadReader(frame + 1, len - 1), id, position);
+ *
+ * Fields are little-endian. Packets have a fixed length: the function
+ * code followed by the fields, with no padding. Encoding a packet takes the
+ * same number of arguments as there are fields, converted to the field
+ * types. Decoding takes references of exactly the field types, so a
+ * handler that disagrees with the schema does not compile. Decoding checks
+ * the length at run time, so a packet from a peer with another schema is
+ * rejected.
+ */
+
+namespace LT {
+  /*!
+   * @brief a fixed list of field types
+   */
+  template <class... FIELDS>
+  struct Schema;
+
+  template <>
+  struct Schema<> {
+    static const uint16_t SIZE = 0;  ///< the number of bytes of the fields
+    static const uint8_t COUNT = 0;  ///< the number of fields
+
+    static void write(PayloadWriter&) {}
+    static void read(PayloadReader&) {}
+    template <class VISITOR>
+    static void visit(PayloadReader&, VISITOR&, const uint8_t = 0) {}
+  };
+
+  template <class FIELD, class... REST>
+  struct Schema<FIELD, REST...> {
+    typedef Schema<REST...> Tail;
+    static const uint16_t SIZE = sizeof(FIELD) + Tail::SIZE;
+    static const uint8_t COUNT = 1 + Tail::COUNT;
+
+    static void write(PayloadWriter &out, const FIELD &value, const REST&... rest) {
+      out.write(value);
+      Tail::write(out, rest...);
+    }
+
+    static void read(PayloadReader &in, FIELD &value, REST&... rest) {
+      in.read(value);
+      Tail::read(in, rest...);
+    }
+
+    /*!
+     * @brief call visitor(index, value) for each field in order, for
+     * example to print a packet without knowing its type
+     */
+    template <class VISITOR>
+    static void visit(PayloadReader &in, VISITOR &visitor, const uint8_t index = 0) {
+      const FIELD value = in.template read<FIELD>();
+      if( in.ok() ) {
+        visitor(index, value);
+      }
+      Tail::visit(in, visitor, index + 1);
+    }
+  };
+
+  /*!
+   * @brief the request and response schemas of a function code
+   * @tparam CODE the function code
+   * @tparam REQUEST the fields sent to the device
+   * @tparam RESPONSE the fields sent back by the device
+   */
+  template <uint8_t CODE, class REQUEST, class RESPONSE = Schema<> >
+  struct Message {
+    typedef REQUEST Request;
+    typedef RESPONSE Response;
+    static const uint8_t FUNCTION = CODE;
+    static const uint16_t REQUEST_LENGTH = 1 + REQUEST::SIZE;   ///< bytes in a request packet
+    static const uint16_t RESPONSE_LENGTH = 1 + RESPONSE::SIZE; ///< bytes in a response packet
+
+    template <class... ARGS>
+    static void encodeRequest(PayloadWriter &out, const ARGS&... values) {
+      out.write(CODE);
+      Request::write(out, values...);
+    }
+
+    template <class... ARGS>
+    static void encodeResponse(PayloadWriter &out, const ARGS&... values) {
+      out.write(CODE);
+      Response::write(out, values...);
+    }
+
+    /*!
+     * @param in the packet after its function code, as from BinarySerial::payload()
+     * @return true if the packet has exactly the fields of the schema
+     */
+    template <class... ARGS>
+    static bool decodeRequest(PayloadReader in, ARGS&... values) {
+      Request::read(in, values...);
+      return ( in.ok() && in.remaining() == 0 );
+    }
+
+    template <class... ARGS>
+    static bool decodeResponse(PayloadReader in, ARGS&... values) {
+      Response::read(in, values...);
+      return ( in.ok() && in.remaining() == 0 );
+    }
+
+    /*!
+     * @brief encode a request into a packet of the exact length and send it
+     * @return the result of messenger.sendPacket()
+     */
+    template <class MESSENGER, class... ARGS>
+    static int8_t sendRequest(MESSENGER &messenger, const ARGS&... values) {
+      Packet<REQUEST_LENGTH> out;
+      encodeRequest(out, values...);
+      return messenger.sendPacket(out);
+    }
+
+    template <class MESSENGER, class... ARGS>
+    static int8_t sendResponse(MESSENGER &messenger, const ARGS&... values) {
+      Packet<RESPONSE_LENGTH> out;
+      encodeResponse(out, values...);
+      return messenger.sendPacket(out);
+    }
+  };
+
+  /*!
+   * @brief the messages of a protocol, to decode packets by their function
+   * code. Two messages with the same function code do not compile
+   */
+  template <class... MESSAGES>
+  struct MessageSet;
+
+  template <>
+  struct MessageSet<> {
+    static bool contains(const uint8_t) { return false; }
+
+    template <class VISITOR>
+    static bool visitRequest(const uint8_t, PayloadReader&, VISITOR&) { return false; }
+
+    template <class VISITOR>
+    static bool visitResponse(const uint8_t, PayloadReader&, VISITOR&) { return false; }
+  };
+
+  template <class MESSAGE, class... REST>
+  struct MessageSet<MESSAGE, REST...> {
+    private:
+      template <uint8_t CODE, class... OTHERS>
+      struct Unique { static const bool value = true; };
+
+      template <uint8_t CODE, class OTHER, class... OTHERS>
+      struct Unique<CODE, OTHER, OTHERS...> {
+        static const bool value = ( CODE != OTHER::FUNCTION ) && Unique<CODE, OTHERS...>::value;
+      };
+
+      static_assert(Unique<MESSAGE::FUNCTION, REST...>::value, "MessageSet has two messages with the same function code");
+
+    public:
+      static bool contains(const uint8_t code) {
+        return ( code == MESSAGE::FUNCTION || MessageSet<REST...>::contains(code) );
+      }
+
+      /*!
+       * @brief call visitor(index, value) for each field of a request
+       * @param code the function code of the packet
+       * @param in the packet after its function code
+       * @return true if the code is in the set and the packet has exactly
+       * the fields of its schema
+       */
+      template <class VISITOR>
+      static bool visitRequest(const uint8_t code, PayloadReader &in, VISITOR &visitor) {
+        if( code != MESSAGE::FUNCTION ) {
+          return MessageSet<REST...>::visitRequest(code, in, visitor);
+        }
+        MESSAGE::Request::visit(in, visitor);
+        return ( in.ok() && in.remaining() == 0 );
+      }
+
+      template <class VISITOR>
+      static bool visitResponse(const uint8_t code, PayloadReader &in, VISITOR &visitor) {
+        if( code != MESSAGE::FUNCTION ) {
+          return MessageSet<REST...>::visitResponse(code, in, visitor);
+        }
+        MESSAGE::Response::visit(in, visitor);
+        return ( in.ok() && in.remaining() == 0 );
+      }
+  };
+
+  /*!
+   * @brief schemas of the packets described in messengers.md
+   */
+  typedef Message<Acknowledge, Schema<uint8_t> > AcknowledgeMessage; ///< the function code that was handled
+  typedef Message<Write_Digital_Output, Schema<uint8_t, uint8_t> > WriteDigitalOutputMessage; ///< port, value
+  typedef Message<Write_Position, Schema<uint8_t, float> > WritePositionMessage; ///< motor id, position
+}
+
+#endif //End __SCHEMA_H__ include guard
@@ -25,7 +25,7 @@ struct DataPoint {
 
 //template <uint8_t POINTS, typename T>
 template <int POINTS, typename T, class TS = typename SelectInteger<POINTS>::type>
-class DataSet : public RingBuffer<POINTS, DataPoint<T> > {
+class DataSet : public OverwritingRingBuffer<POINTS, DataPoint<T> > {
     T _y_min = 1;
     T _y_max = 1;
     T _x_min = 1;
@@ -33,29 +33,30 @@ class DataSet : public RingBuffer<POINTS, DataPoint<T> > {
     
     
     void updateBounds(){
-      if(RingBuffer<POINTS, DataPoint<T> >::isEmpty()) return;
-      DataPoint<T> p;
-      RingBuffer<POINTS, DataPoint<T> >::get(0,&p);
-      _x_min = p.x;
-      _x_max = p.x;
-      _y_min = p.y;
-      _y_max = p.y;
-      TS i = RingBuffer<POINTS, DataPoint<T> >::count();
-      do {
-        RingBuffer<POINTS,DataPoint<T> >::get( i - 1, &p );
-        if(p.x < _x_min) {
-          _x_min = p.x;
-        }
-        if(p.x > _x_max) {
-          _x_max = p.x;
-        }
-        if(p.y < _y_min) {
-          _y_min = p.y;
-        }
-        if(p.y > _y_max) {
-          _y_max = p.y;
+      typename OverwritingRingBuffer<POINTS, DataPoint<T> >::Span spans[2];
+      const uint8_t n = OverwritingRingBuffer<POINTS, DataPoint<T> >::spans(&spans[0], &spans[1]);
+      if(n == 0) return;
+      _x_min = spans[0].data[0].x;
+      _x_max = _x_min;
+      _y_min = spans[0].data[0].y;
+      _y_max = _y_min;
+      for(uint8_t s = 0; s < n; ++s) {
+        const DataPoint<T>* p = spans[s].data;
+        for(TS i = spans[s].length; i > 0; --i, ++p) {
+          if(p->x < _x_min) {
+            _x_min = p->x;
+          }
+          if(p->x > _x_max) {
+            _x_max = p->x;
+          }
+          if(p->y < _y_min) {
+            _y_min = p->y;
+          }
+          if(p->y > _y_max) {
+            _y_max = p->y;
+          }
         }
-      } while ( --i );
+      }
     }
     
     public:
@@ -65,8 +66,23 @@ class DataSet : public RingBuffer<POINTS, DataPoint<T> > {
     inline T yMin(){return _y_min;}
     
     void push(const DataPoint<T> data, DataPoint<T> *taken) {
-       RingBuffer<POINTS,DataPoint<T> >::push(data, taken);
-       updateBounds();
+       const bool evicted = OverwritingRingBuffer<POINTS,DataPoint<T> >::pushOverwrite(data, taken);
+       // only search the whole set when the point that was removed
+       // was on a bound. otherwise the new point can only extend the bounds
+       if( evicted && ( taken->x == _x_min || taken->x == _x_max ||
+         taken->y == _y_min || taken->y == _y_max ) ) {
+         updateBounds();
+       }
+       else if( OverwritingRingBuffer<POINTS,DataPoint<T> >::count() == 1 ) {
+         _x_min = _x_max = data.x;
+         _y_min = _y_max = data.y;
+       }
+       else {
+         if(data.x < _x_min) _x_min = data.x;
+         if(data.x > _x_max) _x_max = data.x;
+         if(data.y < _y_min) _y_min = data.y;
+         if(data.y > _y_max) _y_max = data.y;
+       }
     }
     
 };
@@ -128,42 +144,47 @@ class GraphItem : public GraphicsItem {
     // 235,      240,       245,      246,    251,      0
     
     void drawScatter(UiContext* context) {
-      TS i = dataSet.count();
-      uint8_t my, mx;
-      DataPoint<T> p;
-      do {
-        dataSet.get( i - 1, &p );
-        mx = scaleX(p.x, _x_scale);
-        my = scaleY(p.y, _y_scale);
-        context->display->drawPixel( mx, GRAPH_H - my );
-      } while( --i );
+      typename OverwritingRingBuffer<POINTS, DataPoint<T> >::Span spans[2];
+      const uint8_t n = dataSet.spans(&spans[0], &spans[1]);
+      for(uint8_t s = 0; s < n; ++s) {
+        const DataPoint<T>* p = spans[s].data;
+        for(TS i = spans[s].length; i > 0; --i, ++p) {
+          const uint8_t mx = scaleX(p->x, _x_scale);
+          const uint8_t my = scaleY(p->y, _y_scale);
+          context->display->drawPixel( mx, GRAPH_H - my );
+        }
+      }
     }
     void drawLines(UiContext* context) {
-      TS i = dataSet.count();
-      uint8_t mx1, my1, mx2, my2;
-      DataPoint<T> p1, p2;
-      do {
-        if( i > 1) {
-          dataSet.get(i-2,&p1);
-          dataSet.get(i-1,&p2);
-          mx1 = scaleX(p1.x, _x_scale);
-          my1 = scaleY(p1.y, _y_scale);
-          mx2 = scaleX(p2.x, _x_scale);
-          my2 = scaleY(p2.y, _y_scale);
-          context->display->drawLine(mx1, GRAPH_H-my1, mx2, GRAPH_H-my2);
-        } 
-      } while( --i );
+      typename OverwritingRingBuffer<POINTS, DataPoint<T> >::Span spans[2];
+      const uint8_t n = dataSet.spans(&spans[0], &spans[1]);
+      const DataPoint<T>* last = nullptr;
+      uint8_t mx1 = 0, my1 = 0;
+      for(uint8_t s = 0; s < n; ++s) {
+        const DataPoint<T>* p = spans[s].data;
+        for(TS i = spans[s].length; i > 0; --i, ++p) {
+          const uint8_t mx2 = scaleX(p->x, _x_scale);
+          const uint8_t my2 = scaleY(p->y, _y_scale);
+          if(last != nullptr) {
+            context->display->drawLine(mx1, GRAPH_H-my1, mx2, GRAPH_H-my2);
+          }
+          last = p;
+          mx1 = mx2;
+          my1 = my2;
+        }
+      }
     }
     void drawBars(UiContext* context) {
-      TS i = dataSet.count();
-      uint8_t my, mx;
-      DataPoint<T> p;
-      do {
-        dataSet.get( i - 1, &p );
-        mx = scaleX(p.x, _x_scale);
-        my = scaleY(p.y, _y_scale);
-        context->display->drawVLine( mx, GRAPH_H - my, my );
-      } while( --i );
+      typename OverwritingRingBuffer<POINTS, DataPoint<T> >::Span spans[2];
+      const uint8_t n = dataSet.spans(&spans[0], &spans[1]);
+      for(uint8_t s = 0; s < n; ++s) {
+        const DataPoint<T>* p = spans[s].data;
+        for(TS i = spans[s].length; i > 0; --i, ++p) {
+          const uint8_t mx = scaleX(p->x, _x_scale);
+          const uint8_t my = scaleY(p->y, _y_scale);
+          context->display->drawVLine( mx, GRAPH_H - my, my );
+        }
+      }
     }
     
     void drawAxes(UiContext* context) {
@@ -227,6 +248,14 @@ class GraphItem : public GraphicsItem {
     void setGraphType(uint8_t type) {
       _graph_type = type;
     }
+
+    /*!
+     * @brief print the y value of the newest point next to it
+     */
+    void setLabelLastPoint(const bool label) {
+      _label_last_point = label;
+      setDirty(true);
+    }
     void draw(UiContext* context) {
       //confirm font
       context->setCurrentFont(context->getFontSmall());
@@ -251,9 +280,8 @@ class GraphItem : public GraphicsItem {
           }
         }
      
-        if(_label_last_point) {
-            DataPoint<T> p;
-            dataSet.first(&p);
+        if( _label_last_point && !dataSet.isEmpty() ) {
+            const DataPoint<T> p = dataSet.newest();
             uint8_t mx = scaleX(p.x, _x_scale);
             uint8_t my = scaleY(p.y, _y_scale);
             context->display->setCursor(mx - 24, GRAPH_H - my);
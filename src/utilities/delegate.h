@@ -0,0 +1,133 @@
+#ifndef __DELEGATE_H__
+#define __DELEGATE_H__
+
+/*!
+ * @file delegate.h
+ *
+ * LT::Delegate<Sig> is a callback that can call a free function or a
+ * member function of a particular object. It is two pointers in size,
+ * does not allocate, and can be copied and compared to nullptr like a
+ * function pointer.
+ *
+ * A plain function (or a lambda without captures) converts to a delegate,
+ * so existing sketches do not change:
+ *
+ * timer.setCallback(onTimeout);
+ *
+ * A member function is bound to an object with LT::Delegate<Sig>::member():
+ *
+ * class Pump { public: void onPressure(); };
+ * Pump pump;
+ * sensor.setNewDataCallback(LT::Delegate<void()>::member<Pump, &Pump::onPressure>(&pump));
+ *
+ * Calling a free function is one indirect call. A member function goes
+ * through a generated stub that calls it directly, which is also one
+ * indirect call.
+ *
+ * LT::Delegate<Sig>::bind<T, FUNCTION>(object) calls FUNCTION(object, args...),
+ * for adapters that convert the arguments before calling the object.
+ */
+
+namespace LT
+{
+  template <class Sig>
+  class Delegate;
+
+  template <class R, class... Args>
+  class Delegate<R(Args...)> {
+    public:
+      typedef R (*Function)(Args...);
+
+    private:
+      typedef R (*Stub)(void*, Args...);
+
+      void* _object; ///< the object of a member function, nullptr for a free function
+      union {
+        Function _function; ///< the free function when _object is nullptr
+        Stub _stub; ///< calls the member function on _object
+      };
+
+      template <class T, R (T::*METHOD)(Args...)>
+      static R memberStub(void* object, Args... args) {
+        return (static_cast<T*>(object)->*METHOD)(args...);
+      }
+
+      template <class T, R (T::*METHOD)(Args...) const>
+      static R constMemberStub(void* object, Args... args) {
+        return (static_cast<const T*>(object)->*METHOD)(args...);
+      }
+
+      template <class T, R (*FUNCTION)(T*, Args...)>
+      static R boundStub(void* object, Args... args) {
+        return FUNCTION(static_cast<T*>(object), args...);
+      }
+
+      // a stub can not be called without its object, so a null object
+      // makes an empty delegate, like a null function pointer
+      Delegate(void* object, Stub stub) : _object(object), _stub(stub) {
+        if( _object == nullptr ) {
+          _function = nullptr;
+        }
+      }
+
+    public:
+      Delegate() : _object(nullptr), _function(nullptr) {}
+
+      Delegate(Function f) : _object(nullptr), _function(f) {}
+
+      /*!
+       * @brief convert a lambda without captures, or anything else that
+       * converts to a function pointer. Lambdas with captures do not
+       * compile, since the delegate can not store their state
+       */
+      template <class F>
+      Delegate(const F& f) : _object(nullptr), _function(static_cast<Function>(f)) {}
+
+      /*!
+       * @brief make a delegate that calls object->METHOD(args...). A null
+       * object gives an empty delegate
+       */
+      template <class T, R (T::*METHOD)(Args...)>
+      static Delegate member(T* object) {
+        return Delegate(static_cast<void*>(object), &memberStub<T, METHOD>);
+      }
+
+      template <class T, R (T::*METHOD)(Args...) const>
+      static Delegate member(const T* object) {
+        return Delegate(const_cast<void*>(static_cast<const void*>(object)), &constMemberStub<T, METHOD>);
+      }
+
+      /*!
+       * @brief make a delegate that calls FUNCTION(object, args...). A null
+       * object gives an empty delegate
+       */
+      template <class T, R (*FUNCTION)(T*, Args...)>
+      static Delegate bind(T* object) {
+        return Delegate(static_cast<void*>(object), &boundStub<T, FUNCTION>);
+      }
+
+      R operator()(Args... args) const {
+        if( _object != nullptr ) {
+          return _stub(_object, args...);
+        }
+        return _function(args...);
+      }
+
+      bool isNull() const {
+        return ( _object == nullptr && _function == nullptr );
+      }
+
+      explicit operator bool() const { return !isNull(); }
+
+      bool operator==(decltype(nullptr)) const { return isNull(); }
+      bool operator!=(decltype(nullptr)) const { return !isNull(); }
+
+      bool operator==(const Delegate& other) const {
+        return ( _object == other._object &&
+          (_object == nullptr ? _function == other._function : _stub == other._stub) );
+      }
+      bool operator!=(const Delegate& other) const { return !(*this == other); }
+  };
+}
+
+#endif //End __DELEGATE_H__ include guard
@@ -0,0 +1,323 @@
+#ifndef __EVENT_BUS_H__
+#define __EVENT_BUS_H__
+
+#include <string.h>
+#include "../devices/device.h"
+#include "delegate.h"
+
+/*!
+ * @file event_bus.h
+ *
+ * LT_EventBus delivers events to any number of subscribers, so one sensor
+ * reading or button press can reach the UI, a logger and a messenger
+ * without chaining callbacks by hand.
+ *
+ * Events are posted into a fixed queue and delivered from update(), in the
+ * DeviceManager loop. post() is safe to call from interrupts. Each event
+ * is passed to every subscriber of its topic, in the order they subscribed.
+ * Nothing is allocated: the number of subscribers and the queue length are
+ * template parameters.
+ *
+ * LT_EventBus<8> bus(device_manager.registerDevice());
+ * bus.subscribe(LT::Event_NewData, onNewData); // void onNewData(const LT::Event& e)
+ * sensor.setNewDataCallback(bus.publisher<LT::Event_NewData, SENSOR_ID>());
+ *
+ * A Topic gives a topic number a value type, so the compiler checks that
+ * publishers and subscribers agree on it:
+ *
+ * typedef LT::Topic<LT::Event_User, float> Temperature;
+ * void onTemperature(float celsius) { ... }
+ * bus.subscribe<Temperature, onTemperature>();
+ * bus.publish<Temperature>(21.5f, SENSOR_ID);
+ */
+
+namespace LT {
+  enum EventTopic : uint8_t {
+    Event_None = 0, ///< an empty subscriber slot
+    Event_NewData = 1, ///< a sensor has a new reading
+    Event_ButtonPressed = 2,
+    Event_ButtonReleased = 3,
+    Event_ValueChanged = 4, ///< an encoder or input changed, value is the new value
+    Event_CommandStarted = 5, ///< value is the command index
+    Event_CommandEnded = 6, ///< value is the command index
+    Event_ProcessEnded = 7,
+    Event_Error = 8, ///< value is the error code
+    Event_User = 32, ///< first topic for sketch defined events
+    Event_Any = 0xFF ///< subscribe to every topic
+  };
+
+  /*!
+   * @brief an event passed to the subscribers of its topic
+   */
+  struct Event {
+    uint8_t topic; ///< an EventTopic or a sketch defined topic from Event_User
+    uint8_t source; ///< the id of the device that posted the event
+    int32_t value; ///< data for the event, depends on the topic
+  };
+
+  typedef Delegate<void(const Event&)> EventHandler;
+
+  /*!
+   * @brief a topic whose events carry a value of type T. The value is
+   * stored in the bits of Event::value, so T must fit in 4 bytes and be
+   * copyable with memcpy()
+   *
+   * @tparam ID the topic, from Event_User for sketch defined topics
+   * @tparam T the type of the value
+   */
+  template <uint8_t ID, class T>
+  struct Topic {
+    static_assert(sizeof(T) <= sizeof(int32_t), "A Topic value must fit in the 32-bit event value");
+    static_assert(ID != Event_None && ID != Event_Any, "A Topic can not use Event_None or Event_Any");
+    typedef T Type;
+    static const uint8_t NUMBER = ID; ///< the topic of the events
+
+    static int32_t pack(const T &value) {
+      int32_t bits = 0;
+      memcpy(&bits, &value, sizeof(T));
+      return bits;
+    }
+
+    static T unpack(const Event &e) {
+      T value;
+      memcpy(&value, &e.value, sizeof(T));
+      return value;
+    }
+  };
+}
+
+/*!
+ * @tparam N_SUBSCRIBERS the number of subscriptions (at most 255)
+ * @tparam QUEUE_LENGTH the number of events that can wait for delivery,
+ * a power of 2 (at most 128)
+ */
+template <uint8_t N_SUBSCRIBERS, uint8_t QUEUE_LENGTH = 16>
+class LT_EventBus : public LT_Device {
+    static const uint8_t MASK = QUEUE_LENGTH - 1;
+
+    uint8_t _topics[N_SUBSCRIBERS]; ///< the topic of each subscription, Event_None if the slot is free
+    LT::EventHandler _handlers[N_SUBSCRIBERS]; ///< the handler of each subscription
+    uint8_t _n_subscribers = 0; ///< one past the last used subscription slot
+
+    LT::Event _queue[QUEUE_LENGTH]; ///< events waiting for delivery
+    volatile uint8_t _head = 0; ///< index of the next free queue slot
+    volatile uint8_t _count = 0; ///< the number of queued events
+    volatile uint16_t _dropped = 0; ///< events lost because the queue was full
+#if defined(ARDUINO_ARCH_ESP32)
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+    // the queue is shared by the loop and any number of interrupts
+#if defined(__AVR__)
+    uint8_t lock() { const uint8_t sreg = SREG; cli(); return sreg; }
+    void unlock(const uint8_t sreg) { SREG = sreg; }
+#elif defined(ARDUINO_ARCH_ESP32)
+    uint8_t lock() { portENTER_CRITICAL_SAFE(&_mux); return 0; }
+    void unlock(const uint8_t) { portEXIT_CRITICAL_SAFE(&_mux); }
+#else
+    uint8_t lock() { noInterrupts(); return 0; }
+    void unlock(const uint8_t) { interrupts(); }
+#endif
+
+    template <uint8_t TOPIC, uint8_t SOURCE>
+    void postTopic() { post(TOPIC, SOURCE); }
+
+    template <uint8_t TOPIC, uint8_t SOURCE>
+    void postTopicValue(int value) { post(TOPIC, SOURCE, value); }
+
+    // adapters from the event handler to handlers that take the topic value
+    template <class TOPIC, void (*HANDLER)(typename TOPIC::Type)>
+    static void deliverValue(const LT::Event &e) { HANDLER(TOPIC::unpack(e)); }
+
+    template <class TOPIC, class T, void (T::*HANDLER)(typename TOPIC::Type)>
+    static void deliverMemberValue(T *object, const LT::Event &e) { (object->*HANDLER)(TOPIC::unpack(e)); }
+
+    template <class TOPIC, class T, void (T::*HANDLER)(typename TOPIC::Type)>
+    static LT::EventHandler memberValueHandler(T *object) {
+      return LT::EventHandler::template bind<T, &LT_EventBus::template deliverMemberValue<TOPIC, T, HANDLER> >(object);
+    }
+
+  public:
+    LT_EventBus(const uint8_t id) : LT_Device(id) {
+      static_assert(N_SUBSCRIBERS > 0, "LT_EventBus needs at least one subscriber");
+      static_assert(QUEUE_LENGTH > 0 && QUEUE_LENGTH <= 128 && (QUEUE_LENGTH & (QUEUE_LENGTH - 1)) == 0,
+        "LT_EventBus queue length must be a power of 2, at most 128");
+      for( uint8_t i = 0; i < N_SUBSCRIBERS; ++i ) {
+        _topics[i] = LT::Event_None;
+      }
+    }
+
+    LT::DeviceType type() const { return LT::UserType; }
+
+    LT_EventBus* instance() { return this; }
+
+    /*!
+     * @brief call a handler for every event of a topic
+     *
+     * @param topic the topic to receive, or Event_Any for all topics
+     * @param handler called with each event from update()
+     * @return int8_t 0 on success, -1 if there is no free subscription
+     */
+    int8_t subscribe(const uint8_t topic, LT::EventHandler handler) {
+      if( topic == LT::Event_None || handler == nullptr ) return -1;
+      for( uint8_t i = 0; i < N_SUBSCRIBERS; ++i ) {
+        if( _topics[i] == LT::Event_None ) {
+          _handlers[i] = handler;
+          _topics[i] = topic;
+          if( i >= _n_subscribers ) {
+            _n_subscribers = i + 1;
+          }
+          return 0;
+        }
+      }
+      return -1;
+    }
+
+    /*!
+     * @brief call HANDLER with the value of every event of a typed topic.
+     * A handler that does not take the value type of the topic does not compile
+     *
+     * @return int8_t 0 on success, -1 if there is no free subscription
+     */
+    template <class TOPIC, void (*HANDLER)(typename TOPIC::Type)>
+    int8_t subscribe() {
+      return subscribe(TOPIC::NUMBER, &deliverValue<TOPIC, HANDLER>);
+    }
+
+    /*!
+     * @brief call object->HANDLER with the value of every event of a typed topic
+     */
+    template <class TOPIC, class T, void (T::*HANDLER)(typename TOPIC::Type)>
+    int8_t subscribe(T *object) {
+      return subscribe(TOPIC::NUMBER, memberValueHandler<TOPIC, T, HANDLER>(object));
+    }
+
+    template <class TOPIC, void (*HANDLER)(typename TOPIC::Type)>
+    int8_t unsubscribe() {
+      return unsubscribe(TOPIC::NUMBER, &deliverValue<TOPIC, HANDLER>);
+    }
+
+    template <class TOPIC, class T, void (T::*HANDLER)(typename TOPIC::Type)>
+    int8_t unsubscribe(T *object) {
+      return unsubscribe(TOPIC::NUMBER, memberValueHandler<TOPIC, T, HANDLER>(object));
+    }
+
+    /*!
+     * @brief remove a subscription. Safe to call from a handler
+     *
+     * @return int8_t 0 on success, -1 if the subscription was not found
+     */
+    int8_t unsubscribe(const uint8_t topic, LT::EventHandler handler) {
+      for( uint8_t i = 0; i < _n_subscribers; ++i ) {
+        if( _topics[i] == topic && _handlers[i] == handler ) {
+          _topics[i] = LT::Event_None;
+          _handlers[i] = nullptr;
+          while( _n_subscribers > 0 && _topics[_n_subscribers - 1] == LT::Event_None ) {
+            _n_subscribers--;
+          }
+          return 0;
+        }
+      }
+      return -1;
+    }
+
+    /*!
+     * @brief queue an event for delivery in the next update(). Safe to call
+     * from interrupts and from handlers
+     *
+     * @return int8_t 0 on success, -1 if the queue is full and the event was dropped
+     */
+    int8_t post(const uint8_t topic, const uint8_t source = 0, const int32_t value = 0) {
+      const uint8_t state = lock();
+      if( _count >= QUEUE_LENGTH ) {
+        _dropped++;
+        unlock(state);
+        return -1;
+      }
+      LT::Event& e = _queue[_head];
+      e.topic = topic;
+      e.source = source;
+      e.value = value;
+      _head = (_head + 1) & MASK;
+      _count++;
+      unlock(state);
+      return 0;
+    }
+
+    /*!
+     * @brief queue an event of a typed topic. Safe to call from interrupts
+     *
+     * @param value converted to the value type of the topic
+     * @return int8_t 0 on success, -1 if the queue is full and the event was dropped
+     */
+    template <class TOPIC>
+    int8_t publish(const typename TOPIC::Type &value, const uint8_t source = 0) {
+      return post(TOPIC::NUMBER, source, TOPIC::pack(value));
+    }
+
+    /*!
+     * @brief deliver an event to its subscribers now, without queueing it.
+     * Not safe to call from interrupts
+     */
+    void dispatch(const LT::Event& e) const {
+      for( uint8_t i = 0; i < _n_subscribers; ++i ) {
+        const uint8_t topic = _topics[i];
+        if( topic != LT::Event_None && (topic == e.topic || topic == LT::Event_Any) ) {
+          _handlers[i](e);
+        }
+      }
+    }
+
+    /*!
+     * @brief make a callback that posts an event of a fixed topic and source,
+     * for device callbacks such as setNewDataCallback()
+     */
+    template <uint8_t TOPIC, uint8_t SOURCE = 0>
+    LT::Delegate<void()> publisher() {
+      return LT::Delegate<void()>::template member<LT_EventBus, &LT_EventBus::template postTopic<TOPIC, SOURCE> >(this);
+    }
+
+    /*!
+     * @brief make a callback that posts its int argument as the event value,
+     * for callbacks such as setCommandStartedCallback()
+     */
+    template <uint8_t TOPIC, uint8_t SOURCE = 0>
+    LT::Delegate<void(int)> valuePublisher() {
+      return LT::Delegate<void(int)>::template member<LT_EventBus, &LT_EventBus::template postTopicValue<TOPIC, SOURCE> >(this);
+    }
+
+    /*!
+     * @return the number of events waiting for delivery
+     */
+    uint8_t pending() const { return _count; }
+
+    /*!
+     * @return the number of events dropped because the queue was full
+     */
+    uint16_t dropped() const { return _dropped; }
+
+    uint8_t subscriberCount() const {
+      uint8_t n = 0;
+      for( uint8_t i = 0; i < _n_subscribers; ++i ) {
+        n += (_topics[i] != LT::Event_None);
+      }
+      return n;
+    }
+
+    /*!
+     * @brief deliver the queued events. Events posted by the handlers
+     * are delivered in the next update()
+     */
+    void update() {
+      uint8_t n = _count;
+      while( n-- ) {
+        const uint8_t state = lock();
+        const LT::Event e = _queue[(uint8_t)(_head - _count) & MASK];
+        _count--;
+        unlock(state);
+        dispatch(e);
+      }
+    }
+};
+
+#endif //End __EVENT_BUS_H__ include guard
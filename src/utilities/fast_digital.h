@@ -1,186 +0,0 @@
-/* Fast Digital*/
-
-#if defined(__AVR_ATmega8__)
-#define digitalPinToPortReg(P) \
-(((P) >= 0 && (P) <= 7) ? &PORTD : (((P) >= 8 && (P) <= 13) ? &PORTB : &PORTC))
-#define digitalPinToDDRReg(P) \
-(((P) >= 0 && (P) <= 7) ? &DDRD : (((P) >= 8 && (P) <= 13) ? &DDRB : &DDRC))
-#define digitalPinToPINReg(P) \
-(((P) >= 0 && (P) <= 7) ? &PIND : (((P) >= 8 && (P) <= 13) ? &PINB : &PINC))
-#define digitalPinToBit(P) \
-(((P) >= 0 && (P) <= 7) ? (P) : (((P) >= 8 && (P) <= 13) ? (P) - 8 : (P) - 14))
-#define digitalPinToTimer(P) \
-(((P) ==  9 || (P) == 10) ? &TCCR1A : (((P) == 11) ? &TCCR2 : 0))
-#define digitalPinToTimerBit(P) \
-(((P) ==  9) ? COM1A1 : (((P) == 10) ? COM1B1 : COM21))
-#endif
-
-//Map PIN numbers to port registers on ATMega 328p
-#if defined(__AVR_ATmega328P__)
-#define digitalPinToPortReg(P) \
-(((P) >= 0 && (P) <= 7) ? PORTD : (((P) >= 8 && (P) <= 13) ? PORTB : PORTC))
-#define digitalPinToDDRReg(P) \
-(((P) >= 0 && (P) <= 7) ? DDRD : (((P) >= 8 && (P) <= 13) ? DDRB : DDRC))
-#define digitalPinToPINReg(P) \
-(((P) >= 0 && (P) <= 7) ? &PIND : (((P) >= 8 && (P) <= 13) ? &PINB : &PINC))
-#define digitalPinToBit(P) \
-(((P) >= 0 && (P) <= 7) ? (P) : (((P) >= 8 && (P) <= 13) ? (P) - 8 : (P) - 14))
-#define digitalPinToTimer(P) \
-(((P) ==  6 || (P) ==  5) ? &TCCR0A : \
-(((P) ==  9 || (P) == 10) ? &TCCR1A : \
-(((P) == 11 || (P) ==  3) ? &TCCR2A : 0)))
-#define digitalPinToTimerBit(P) \
-(((P) ==  6) ? COM0A1 : (((P) ==  5) ? COM0B1 : \
-(((P) ==  9) ? COM1A1 : (((P) == 10) ? COM1B1 : \
-(((P) == 11) ? COM2A1 : COM2B1)))))
-#endif//328p
-
-//Map PIN numbers to port registers on the ATMega 32u4//DOUBLE CHECK THIS
-#if defined(__AVR_ATmega32U4__)
-#define digitalPinToPortReg(P) \
-((P>=8 && P <=11) ? PORTB : ((P==5 || P == 13) ? PORTC : ((P==7)? PORTE : PORTD)))
-#define digitalPinToDDRReg(P) \
-((P>=8 && P <=11) ? PORTB : ((P==5 || P == 13) ? PORTC : ((P==7)? PORTE : PORTD)))
-#define digitalPinToPINReg(P) \
-(((P) >= 0 && (P) <= 7) ? &PIND : (((P) >= 8 && (P) <= 13) ? &PINB : &PINC))
-#define digitalPinToBit(P) \
-(((P) >= 0 && (P) <= 7) ? (P) : (((P) >= 8 && (P) <= 13) ? (P) - 8 : (P) - 14))
-#define digitalPinToTimer(P) \
-(((P) ==  6 || (P) ==  5) ? &TCCR0A : \
-(((P) ==  9 || (P) == 10) ? &TCCR1A : \
-(((P) == 11 || (P) ==  3) ? &TCCR2A : 0)))
-#define digitalPinToTimerBit(P) \
-(((P) ==  6) ? COM0A1 : (((P) ==  5) ? COM0B1 : \
-(((P) ==  9) ? COM1A1 : (((P) == 10) ? COM1B1 : \
-(((P) == 11) ? COM2A1 : COM2B1)))))
-#endif//32u4
-
-
-// Arduino Mega Pins
-#if ( defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega2561__) )
-#define digitalPinToPortReg(P) \
-(((P) >= 22 && (P) <= 29) ? &PORTA : \
-        ((((P) >= 10 && (P) <= 13) || ((P) >= 50 && (P) <= 53)) ? &PORTB : \
-        (((P) >= 30 && (P) <= 37) ? &PORTC : \
-        ((((P) >= 18 && (P) <= 21) || (P) == 38) ? &PORTD : \
-        ((((P) >= 0 && (P) <= 3) || (P) == 5) ? &PORTE : \
-        (((P) >= 54 && (P) <= 61) ? &PORTF : \
-        ((((P) >= 39 && (P) <= 41) || (P) == 4) ? &PORTG : \
-        ((((P) >= 6 && (P) <= 9) || (P) == 16 || (P) == 17) ? &PORTH : \
-        (((P) == 14 || (P) == 15) ? &PORTJ : \
-        (((P) >= 62 && (P) <= 69) ? &PORTK : &PORTL))))))))))
-
-#define digitalPinToDDRReg(P) \
-(((P) >= 22 && (P) <= 29) ? &DDRA : \
-        ((((P) >= 10 && (P) <= 13) || ((P) >= 50 && (P) <= 53)) ? &DDRB : \
-        (((P) >= 30 && (P) <= 37) ? &DDRC : \
-        ((((P) >= 18 && (P) <= 21) || (P) == 38) ? &DDRD : \
-        ((((P) >= 0 && (P) <= 3) || (P) == 5) ? &DDRE : \
-        (((P) >= 54 && (P) <= 61) ? &DDRF : \
-        ((((P) >= 39 && (P) <= 41) || (P) == 4) ? &DDRG : \
-        ((((P) >= 6 && (P) <= 9) || (P) == 16 || (P) == 17) ? &DDRH : \
-        (((P) == 14 || (P) == 15) ? &DDRJ : \
-        (((P) >= 62 && (P) <= 69) ? &DDRK : &DDRL))))))))))
-
-#define digitalPinToPINReg(P) \
-(((P) >= 22 && (P) <= 29) ? &PINA : \
-        ((((P) >= 10 && (P) <= 13) || ((P) >= 50 && (P) <= 53)) ? &PINB : \
-        (((P) >= 30 && (P) <= 37) ? &PINC : \
-        ((((P) >= 18 && (P) <= 21) || (P) == 38) ? &PIND : \
-        ((((P) >= 0 && (P) <= 3) || (P) == 5) ? &PINE : \
-        (((P) >= 54 && (P) <= 61) ? &PINF : \
-        ((((P) >= 39 && (P) <= 41) || (P) == 4) ? &PING : \
-        ((((P) >= 6 && (P) <= 9) || (P) == 16 || (P) == 17) ? &PINH : \
-        (((P) == 14 || (P) == 15) ? &PINJ : \
-        (((P) >= 62 && (P) <= 69) ? &PINK : &PINL))))))))))
-
-#define digitalPinToBit(P) \
-(((P) >=  7 && (P) <=  9) ? (P) - 3 : \
-        (((P) >= 10 && (P) <= 13) ? (P) - 6 : \
-        (((P) >= 22 && (P) <= 29) ? (P) - 22 : \
-        (((P) >= 30 && (P) <= 37) ? 37 - (P) : \
-        (((P) >= 39 && (P) <= 41) ? 41 - (P) : \
-        (((P) >= 42 && (P) <= 49) ? 49 - (P) : \
-        (((P) >= 50 && (P) <= 53) ? 53 - (P) : \
-        (((P) >= 54 && (P) <= 61) ? (P) - 54 : \
-        (((P) >= 62 && (P) <= 69) ? (P) - 62 : \
-        (((P) == 0 || (P) == 15 || (P) == 17 || (P) == 21) ? 0 : \
-        (((P) == 1 || (P) == 14 || (P) == 16 || (P) == 20) ? 1 : \
-        (((P) == 19) ? 2 : \
-        (((P) == 5 || (P) == 6 || (P) == 18) ? 3 : \
-        (((P) == 2) ? 4 : \
-        (((P) == 3 || (P) == 4) ? 5 : 7)))))))))))))))
-#define digitalPinToTimer(P) \
-(((P) ==  6 || (P) ==  5) ? &TCCR0A : \
-(((P) ==  9 || (P) == 10) ? &TCCR1A : \
-(((P) == 11 || (P) ==  3) ? &TCCR2A : 0)))
-#define digitalPinToTimerBit(P) \
-(((P) ==  6) ? COM0A1 : (((P) ==  5) ? COM0B1 : \
-(((P) ==  9) ? COM1A1 : (((P) == 10) ? COM1B1 : \
-(((P) == 11) ? COM2A1 : COM2B1)))))
-#endif// Mega
-
-#if !defined(digitalWriteFast2)
-#define digitalWriteFast2(P, V) \
-if (__builtin_constant_p(P) && __builtin_constant_p(V)) { \
-                bitWrite(*digitalPinToPortReg(P), digitalPinToBit(P), (V)); \
-        } else { \
-                digitalWrite((P), (V)); \
-        }
-#endif
-
-#if !defined(pinModeFast2)
-#define pinModeFast2(P, V) \
-if (__builtin_constant_p(P) && __builtin_constant_p(V)) { \
-                if (digitalPinToTimer(P)) \
-                        bitClear(*digitalPinToTimer(P), digitalPinToTimerBit(P)); \
-                bitWrite(*digitalPinToDDRReg(P), digitalPinToBit(P), (V)); \
-        } else {  \
-                pinMode((P), (V)); \
-        } 
-#endif
-
-#if !defined(digitalReadFast2)
-#define digitalReadFast2(P) ( (int) __digitalReadFast2__((P)) )
-#define __digitalReadFast2__(P ) \
-(__builtin_constant_p(P) ) ? ( \
-                ( bitRead(*digitalPinToPINReg(P), digitalPinToBit(P))) ) : \
-                digitalRead((P))
-#endif
-
-// replace arduino functions
-/*#define digitalWrite(P, V) digitalWriteFast2(P, V)
-#define pinMode(P, V) pinModeFast2(P, V)
-#define digitalRead(P) digitalReadFast2(P)*/
-
-
-
-/*
-//these macros map PIN numbers to port registers for faster digital PIN manipulation
-#ifdef FAST_DIGITAL
-//Maps PIN numbers to bit numbers
-#define __digitalPinToBit(P) \
-(((P) >= 0 && (P) <= 7) ? (P) : (((P) >= 8 && (P) <= 13) ? (P) - 8 : (P) - 14))
-
-//Map PIN numbers to port registers on ATMega 328p
-#if defined(__AVR_ATmega328P__)
-#define digitalPinToPortReg(P) \
-(((P) >= 0 && (P) <= 7) ? PORTD : (((P) >= 8 && (P) <= 13) ? PORTB : PORTC))
-#define digitalPinToDDRReg(P) \
-(((P) >= 0 && (P) <= 7) ? DDRD : (((P) >= 8 && (P) <= 13) ? DDRB : DDRC))
-#endif//328p
-
-//Map PIN numbers to port registers on the ATMega 32u4//DOUBLE CHECK THIS
-#if defined(__AVR_ATmega32U4__)
-#define digitalPinToPortReg(P) \
-((P>=8 && P <=11) ? PORTB : ((P==5 || P == 13) ? PORTC : ((P==7)? PORTE : PORTD)))
-#define digitalPinToDDRReg(P) \
-((P>=8 && P <=11) ? PORTB : ((P==5 || P == 13) ? PORTC : ((P==7)? PORTE : PORTD)))
-#endif//32u4
-
-#define digitalRead(pin) digitalPinToPortReg(pin)&_BV(__digitalPinToBit(pin))
-#define digitalWrite(pin, LOW) digitalPinToPortReg(pin) &= ~(1<<__digitalPinToBit(pin))
-#define digitalWrite(pin, HIGH) digitalPinToPortReg(pin) |= 1<<__digitalPinToBit(pin)
-
-#endif // FAST_DIGITAL
-*/
\ No newline at end of file
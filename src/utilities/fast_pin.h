@@ -0,0 +1,210 @@
+#ifndef __FAST_PIN_H__
+#define __FAST_PIN_H__
+
+/*!
+ * @file fast_pin.h
+ *
+ * FastPin<PIN> resolves the port registers and bit mask of a digital pin at
+ * compile time. On AVR, write(), read() and toggle() compile to single
+ * sbi/cbi/in/out instructions instead of the table lookups done by
+ * digitalWrite() and digitalRead().
+ *
+ * LT_Pin has the same interface for a pin number chosen at run time. Device
+ * classes take either one as a template parameter:
+ *
+ * LT_BasicDigitalOutput< FastPin<9> > valve(device_manager.registerDevice());
+ * LT_DigitalOutput led(device_manager.registerDevice(), 13); // LT_Pin
+ *
+ * Unlike digitalWrite(), FastPin does not turn off PWM on the pin.
+ *
+ * Supported boards: ATmega328P/168 (Uno, Nano), ATmega32U4 (Leonardo, Micro, A-Star)
+ * and ATmega1280/2560 (Mega). Other boards fall back to digitalWrite() and digitalRead().
+ * Define LT_SIMULATED_PINS to back FastPin with an array of simulated pin
+ * states (LT::simulatedPins()) for host builds.
+ */
+
+/*!
+ * @brief a digital pin with a pin number chosen at run time
+ */
+class LT_Pin {
+    const uint8_t _pin;
+  public:
+    LT_Pin(const uint8_t pin) : _pin(pin) {}
+    void mode(const uint8_t mode) const { pinMode(_pin, mode); }
+    void write(const uint8_t value) const { digitalWrite(_pin, value); }
+    void high() const { digitalWrite(_pin, HIGH); }
+    void low() const { digitalWrite(_pin, LOW); }
+    void toggle() const { digitalWrite(_pin, !digitalRead(_pin)); }
+    uint8_t read() const { return digitalRead(_pin); }
+    uint8_t number() const { return _pin; }
+};
+
+#if defined(LT_SIMULATED_PINS)
+
+namespace LT
+{
+  /*!
+   * @brief simulated pin output states for host builds
+   */
+  inline volatile uint8_t* simulatedPins() {
+    static volatile uint8_t pins[256] = {0};
+    return pins;
+  }
+}
+
+template <uint8_t PIN>
+class FastPin {
+  public:
+    FastPin(const uint8_t = PIN) {}
+    static void mode(const uint8_t) {}
+    static void write(const uint8_t value) { LT::simulatedPins()[PIN] = ( value != 0 ); }
+    static void high() { LT::simulatedPins()[PIN] = 1; }
+    static void low() { LT::simulatedPins()[PIN] = 0; }
+    static void toggle() { LT::simulatedPins()[PIN] ^= 1; }
+    static uint8_t read() { return LT::simulatedPins()[PIN] & 1; }
+    static constexpr uint8_t number() { return PIN; }
+};
+
+#elif defined(__AVR__)
+
+namespace LT
+{
+  // each map entry holds the port in the upper 5 bits and the bit in the lower 3 bits
+  enum FastPinPort : uint8_t {
+    Port_A = 0 << 3, Port_B = 1 << 3, Port_C = 2 << 3, Port_D = 3 << 3,
+    Port_E = 4 << 3, Port_F = 5 << 3, Port_G = 6 << 3, Port_H = 7 << 3,
+    Port_J = 8 << 3, Port_K = 9 << 3, Port_L = 10 << 3
+  };
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__)
+  constexpr uint8_t FAST_PIN_MAP[] = {
+    Port_D|0, Port_D|1, Port_D|2, Port_D|3, Port_D|4, Port_D|5, Port_D|6, Port_D|7, // 0-7
+    Port_B|0, Port_B|1, Port_B|2, Port_B|3, Port_B|4, Port_B|5, // 8-13
+    Port_C|0, Port_C|1, Port_C|2, Port_C|3, Port_C|4, Port_C|5 // 14-19 (A0-A5)
+  };
+#elif defined(__AVR_ATmega32U4__)
+  constexpr uint8_t FAST_PIN_MAP[] = {
+    Port_D|2, Port_D|3, Port_D|1, Port_D|0, Port_D|4, Port_C|6, Port_D|7, Port_E|6, // 0-7
+    Port_B|4, Port_B|5, Port_B|6, Port_B|7, Port_D|6, Port_C|7, Port_B|3, Port_B|1, // 8-15
+    Port_B|2, Port_B|0, Port_F|7, Port_F|6, Port_F|5, Port_F|4, Port_F|1, Port_F|0, // 16-23
+    Port_D|4, Port_D|7, Port_B|4, Port_B|5, Port_B|6, Port_D|6, Port_D|5 // 24-30
+  };
+#elif defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+  constexpr uint8_t FAST_PIN_MAP[] = {
+    Port_E|0, Port_E|1, Port_E|4, Port_E|5, Port_G|5, Port_E|3, Port_H|3, Port_H|4, // 0-7
+    Port_H|5, Port_H|6, Port_B|4, Port_B|5, Port_B|6, Port_B|7, Port_J|1, Port_J|0, // 8-15
+    Port_H|1, Port_H|0, Port_D|3, Port_D|2, Port_D|1, Port_D|0, Port_A|0, Port_A|1, // 16-23
+    Port_A|2, Port_A|3, Port_A|4, Port_A|5, Port_A|6, Port_A|7, Port_C|7, Port_C|6, // 24-31
+    Port_C|5, Port_C|4, Port_C|3, Port_C|2, Port_C|1, Port_C|0, Port_D|7, Port_G|2, // 32-39
+    Port_G|1, Port_G|0, Port_L|7, Port_L|6, Port_L|5, Port_L|4, Port_L|3, Port_L|2, // 40-47
+    Port_L|1, Port_L|0, Port_B|3, Port_B|2, Port_B|1, Port_B|0, Port_F|0, Port_F|1, // 48-55
+    Port_F|2, Port_F|3, Port_F|4, Port_F|5, Port_F|6, Port_F|7, Port_K|0, Port_K|1, // 56-63
+    Port_K|2, Port_K|3, Port_K|4, Port_K|5, Port_K|6, Port_K|7 // 64-69
+  };
+#else
+#define LT_FAST_PIN_FALLBACK
+#endif
+
+#ifndef LT_FAST_PIN_FALLBACK
+  /*!
+   * @brief the data memory address of the PINx register of a port.
+   * DDRx and PORTx follow at +1 and +2. Ports A-G are in the I/O space
+   * reachable by sbi/cbi, ports H-L (Mega only) are in extended I/O space.
+   */
+  constexpr uint16_t fastPinInputAddress(const uint8_t entry) {
+    return ((entry >> 3) < 7) ? (0x20 + 3 * (entry >> 3)) : (0x100 + 3 * ((entry >> 3) - 7));
+  }
+#endif
+}
+
+#ifndef LT_FAST_PIN_FALLBACK
+template <uint8_t PIN>
+class FastPin {
+    static_assert(PIN < sizeof(LT::FAST_PIN_MAP), "FastPin: pin number is not valid for this board");
+    static constexpr uint16_t IN_ADDRESS = LT::fastPinInputAddress(LT::FAST_PIN_MAP[PIN]);
+    static constexpr uint16_t DDR_ADDRESS = IN_ADDRESS + 1;
+    static constexpr uint16_t OUT_ADDRESS = IN_ADDRESS + 2;
+    static constexpr uint8_t BIT_MASK = 1 << (LT::FAST_PIN_MAP[PIN] & 0x07);
+    // registers above 0x3F can not be written with sbi/cbi, so a
+    // read-modify-write must not be interrupted
+    static constexpr bool IO_SPACE = (OUT_ADDRESS <= 0x3F);
+
+    static volatile uint8_t& reg(const uint16_t address) {
+      return *(volatile uint8_t*)(address);
+    }
+    static void set(const uint16_t address) {
+      if( IO_SPACE ) {
+        reg(address) |= BIT_MASK;
+      }
+      else {
+        const uint8_t sreg = SREG;
+        cli();
+        reg(address) |= BIT_MASK;
+        SREG = sreg;
+      }
+    }
+    static void clear(const uint16_t address) {
+      if( IO_SPACE ) {
+        reg(address) &= ~BIT_MASK;
+      }
+      else {
+        const uint8_t sreg = SREG;
+        cli();
+        reg(address) &= ~BIT_MASK;
+        SREG = sreg;
+      }
+    }
+  public:
+    FastPin(const uint8_t = PIN) {}
+    static void mode(const uint8_t mode) {
+      if( mode == OUTPUT ) {
+        set(DDR_ADDRESS);
+      }
+      else {
+        clear(DDR_ADDRESS);
+        if( mode == INPUT_PULLUP ) {
+          set(OUT_ADDRESS);
+        }
+        else {
+          clear(OUT_ADDRESS);
+        }
+      }
+    }
+    static void write(const uint8_t value) {
+      if( value ) {
+        set(OUT_ADDRESS);
+      }
+      else {
+        clear(OUT_ADDRESS);
+      }
+    }
+    static void high() { set(OUT_ADDRESS); }
+    static void low() { clear(OUT_ADDRESS); }
+    // writing a 1 to PINx toggles PORTx without a read-modify-write
+    static void toggle() { reg(IN_ADDRESS) = BIT_MASK; }
+    static uint8_t read() { return (reg(IN_ADDRESS) & BIT_MASK) ? HIGH : LOW; }
+    static constexpr uint8_t number() { return PIN; }
+};
+#endif
+
+#else
+#define LT_FAST_PIN_FALLBACK
+#endif
+
+#ifdef LT_FAST_PIN_FALLBACK
+template <uint8_t PIN>
+class FastPin {
+  public:
+    FastPin(const uint8_t = PIN) {}
+    static void mode(const uint8_t mode) { pinMode(PIN, mode); }
+    static void write(const uint8_t value) { digitalWrite(PIN, value); }
+    static void high() { digitalWrite(PIN, HIGH); }
+    static void low() { digitalWrite(PIN, LOW); }
+    static void toggle() { digitalWrite(PIN, !digitalRead(PIN)); }
+    static uint8_t read() { return digitalRead(PIN); }
+    static constexpr uint8_t number() { return PIN; }
+};
+#endif
+
+#endif //End __FAST_PIN_H__ include guard
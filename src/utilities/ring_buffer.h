@@ -44,9 +44,16 @@ class RingBuffer {
     // automatically chosen from the length of the buffer
     TS _head = 0;
     TS _tail = 0;
-    T _buffer[BUFFER_LENGTH] = {0};
+    T _buffer[BUFFER_LENGTH] = {};
 
 public:
+    /*!
+     * @brief a contiguous region of the buffer
+     */
+    struct Span {
+      const T* data; ///< the first element of the region
+      TS length; ///< the number of elements in the region
+    };
 
     RingBuffer() {
       static_assert((BUFFER_LENGTH & (BUFFER_LENGTH - 1)) == 0,
@@ -138,6 +145,68 @@ public:
         }
     }
     
+    // adds up to n elements at the head. returns the number added
+    TS putN(const T* data, TS n) {
+        const TS room = size() - count();
+        if(n > room) {
+            n = room;
+        }
+        const TS offset = (_head & (BUFFER_LENGTH - 1));
+        const TS first = (n < BUFFER_LENGTH - offset) ? n : (BUFFER_LENGTH - offset);
+        for(TS i = 0; i < first; ++i) {
+            _buffer[offset + i] = data[i];
+        }
+        for(TS i = first; i < n; ++i) {
+            _buffer[i - first] = data[i];
+        }
+        _head += n;
+        return n;
+    }
+
+    // copies up to n elements, starting at index from the tail,
+    // without modifying the buffer. returns the number copied
+    TS peekN(T* data, TS n, const TS index = 0) const {
+        const TS available = count();
+        if(index >= available) {
+            return 0;
+        }
+        if(n > available - index) {
+            n = available - index;
+        }
+        const TS offset = ((_tail + index) & (BUFFER_LENGTH - 1));
+        const TS first = (n < BUFFER_LENGTH - offset) ? n : (BUFFER_LENGTH - offset);
+        for(TS i = 0; i < first; ++i) {
+            data[i] = _buffer[offset + i];
+        }
+        for(TS i = first; i < n; ++i) {
+            data[i] = _buffer[i - first];
+        }
+        return n;
+    }
+
+    // reads and removes up to n elements at the tail. returns the number taken
+    TS takeN(T* data, TS n) {
+        n = peekN(data, n);
+        _tail += n;
+        return n;
+    }
+
+    /*! the contents of the buffer from the tail (oldest) to the head (newest)
+    * as at most two contiguous regions, so they can be read without
+    * copying or index masking. The spans are valid until the buffer is modified.
+    * returns the number of regions that are not empty (0, 1 or 2)
+    */
+    uint8_t spans(Span* first, Span* second) const {
+        const TS n = count();
+        const TS offset = (_tail & (BUFFER_LENGTH - 1));
+        const TS length = (n < BUFFER_LENGTH - offset) ? n : (BUFFER_LENGTH - offset);
+        first->data = &_buffer[offset];
+        first->length = length;
+        second->data = _buffer;
+        second->length = n - length;
+        return (length > 0 ? 1 : 0) + (n > length ? 1 : 0);
+    }
+
     TS size() const { return BUFFER_LENGTH;}
     TS count() const {return (_head - _tail);}
 
@@ -165,4 +234,119 @@ public:
   }
 };
 
+// A ring buffer that always accepts new data. When it is full, the
+// oldest element is overwritten. The write index wraps with a mask
+// and the count saturates at BUFFER_LENGTH, so pushOverwrite() has no
+// full/empty branches. Elements can be iterated oldest to newest
+// with ++ or newest to oldest with --.
+// BUFFER_LENGTH must be a power of 2
+
+// Example: keep the last 64 readings: OverwritingRingBuffer<64, float> history;
+template <int BUFFER_LENGTH, class T, class TS = typename SelectInteger<BUFFER_LENGTH>::type>
+class OverwritingRingBuffer {
+    static const TS MASK = BUFFER_LENGTH - 1;
+    TS _head = 0; // index of the next write, always masked
+    TS _count = 0; // number of elements, at most BUFFER_LENGTH
+    T _buffer[BUFFER_LENGTH] = {};
+
+    TS tail() const { return (_head - _count) & MASK; }
+
+public:
+    typedef typename RingBuffer<BUFFER_LENGTH, T, TS>::Span Span;
+
+    /*!
+     * @brief a bidirectional iterator. index 0 is the oldest element
+     */
+    class Iterator {
+        const OverwritingRingBuffer* _ring;
+        TS _index;
+      public:
+        Iterator(const OverwritingRingBuffer* ring, const TS index) : _ring(ring), _index(index) {}
+        const T& operator*() const { return _ring->_buffer[(_ring->tail() + _index) & MASK]; }
+        const T* operator->() const { return &(**this); }
+        Iterator& operator++() { ++_index; return *this; }
+        Iterator& operator--() { --_index; return *this; }
+        bool operator==(const Iterator& other) const { return _index == other._index; }
+        bool operator!=(const Iterator& other) const { return _index != other._index; }
+    };
+
+    OverwritingRingBuffer() {
+      static_assert((BUFFER_LENGTH & (BUFFER_LENGTH - 1)) == 0,
+       "Buffer length must be a power of 2");
+    }
+
+    // adds data at the head, overwriting the oldest element if full
+    void pushOverwrite(const T data) {
+        _buffer[_head] = data;
+        _head = (_head + 1) & MASK;
+        _count += (_count != BUFFER_LENGTH);
+    }
+
+    // adds data at the head. if the buffer was full, the oldest element
+    // is copied to overwritten and true is returned. otherwise
+    // overwritten is not written
+    bool pushOverwrite(const T data, T* overwritten) {
+        const bool full = (_count == BUFFER_LENGTH);
+        if(full) {
+            *overwritten = _buffer[_head];
+        }
+        pushOverwrite(data);
+        return full;
+    }
+
+    // gets data from the specified index, 0 is the oldest element
+    // does not modify the contents of the buffer
+    int8_t get(const TS index, T *data) const {
+        if(index < _count) {
+            *data = _buffer[(tail() + index) & MASK];
+            return 0;
+        }
+        else {
+            return -1;
+        }
+    }
+
+    // the element at index from the oldest. index must be less than count()
+    const T& operator[](const TS index) const {
+        return _buffer[(tail() + index) & MASK];
+    }
+
+    // the newest element. the buffer must not be empty
+    const T& newest() const { return _buffer[(_head - 1) & MASK]; }
+    // the oldest element. the buffer must not be empty
+    const T& oldest() const { return _buffer[tail()]; }
+
+    // iterate from the oldest to the newest element: for(const T& x : buffer)
+    // or step back from end() to visit the newest element first
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, _count); }
+
+    /*! the contents of the buffer from the oldest to the newest element
+    * as at most two contiguous regions. returns the number of regions
+    * that are not empty (0, 1 or 2)
+    */
+    uint8_t spans(Span* first, Span* second) const {
+        const TS offset = tail();
+        const TS length = (_count < BUFFER_LENGTH - offset) ? _count : (BUFFER_LENGTH - offset);
+        first->data = &_buffer[offset];
+        first->length = length;
+        second->data = _buffer;
+        second->length = _count - length;
+        return (length > 0 ? 1 : 0) + (_count > length ? 1 : 0);
+    }
+
+    TS size() const { return BUFFER_LENGTH; }
+    TS count() const { return _count; }
+    bool isFull() const { return _count == BUFFER_LENGTH; }
+    bool isEmpty() const { return _count == 0; }
+
+    void reset(const bool full = false) {
+        _head = 0;
+        _count = 0;
+        if (full) {
+            memset (_buffer, 0, sizeof (_buffer));
+        }
+    }
+};
+
 #endif // End __RING_BUFFER_H__ include guard
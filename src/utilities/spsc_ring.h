@@ -0,0 +1,177 @@
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#include <stdint.h>
+
+#if !defined(__AVR__)
+#include <atomic>
+#endif
+
+/*!
+ * @file spsc_ring.h
+ *
+ * SpscRing is a ring buffer for passing data from exactly one producer to
+ * exactly one consumer without disabling interrupts, for example encoder
+ * edges, ADC samples or serial bytes from an ISR to the loop (or the other
+ * way around).
+ *
+ * The producer only writes the head index and the consumer only writes the
+ * tail index. An element is written before the head that publishes it,
+ * and read before the tail that releases its slot.
+ *
+ * AVR: single byte indices, which are read and written atomically, with
+ * compiler barriers for ordering (the core does not reorder memory
+ * accesses). The length is limited to 128.
+ * Other platforms: std::atomic indices with acquire/release ordering.
+ *
+ * RingBuffer<N, T> is not safe to share between an ISR and the loop.
+ *
+ * Example: SpscRing<32, uint16_t> samples;
+ * ISR: samples.put(ADC);
+ * loop: uint16_t s; while( samples.take(&s) == 0 ) { ... }
+ */
+
+template <uint16_t LENGTH, class T>
+class SpscRing {
+#if defined(__AVR__)
+    typedef uint8_t Index;
+    volatile Index _head = 0; ///< written by the producer only
+    volatile Index _tail = 0; ///< written by the consumer only
+
+    static Index loadAcquire(const volatile Index& i) {
+      const Index v = i;
+      asm volatile("" ::: "memory");
+      return v;
+    }
+    static void storeRelease(volatile Index& i, const Index v) {
+      asm volatile("" ::: "memory");
+      i = v;
+    }
+    static Index loadRelaxed(const volatile Index& i) { return i; }
+#else
+    typedef uint32_t Index;
+    std::atomic<Index> _head{0}; ///< written by the producer only
+    std::atomic<Index> _tail{0}; ///< written by the consumer only
+
+    static Index loadAcquire(const std::atomic<Index>& i) {
+      return i.load(std::memory_order_acquire);
+    }
+    static void storeRelease(std::atomic<Index>& i, const Index v) {
+      i.store(v, std::memory_order_release);
+    }
+    static Index loadRelaxed(const std::atomic<Index>& i) {
+      return i.load(std::memory_order_relaxed);
+    }
+#endif
+    static const Index MASK = LENGTH - 1;
+
+    T _buffer[LENGTH];
+
+  public:
+    SpscRing() {
+      static_assert((LENGTH & (LENGTH - 1)) == 0, "Buffer length must be a power of 2");
+#if defined(__AVR__)
+      static_assert(LENGTH <= 128, "SpscRing length is limited to 128 on AVR");
+#endif
+    }
+
+    /*!
+     * @brief Producer: add an element at the head if there is room
+     * @return int8_t 0 on success, -1 if the buffer is full
+     */
+    int8_t put(const T& data) {
+      const Index head = loadRelaxed(_head);
+      if( (Index)(head - loadAcquire(_tail)) >= LENGTH ) {
+        return -1;
+      }
+      _buffer[head & MASK] = data;
+      storeRelease(_head, head + 1);
+      return 0;
+    }
+
+    /*!
+     * @brief Producer: add up to n elements, publishing them all at once
+     * @return uint16_t the number of elements added
+     */
+    uint16_t putN(const T* data, uint16_t n) {
+      const Index head = loadRelaxed(_head);
+      const uint16_t room = LENGTH - (Index)(head - loadAcquire(_tail));
+      if( n > room ) {
+        n = room;
+      }
+      for( uint16_t i = 0; i < n; ++i ) {
+        _buffer[(Index)(head + i) & MASK] = data[i];
+      }
+      storeRelease(_head, head + n);
+      return n;
+    }
+
+    /*!
+     * @brief Consumer: remove the oldest element
+     * @return int8_t 0 on success, -1 if the buffer is empty
+     */
+    int8_t take(T* data) {
+      const Index tail = loadRelaxed(_tail);
+      if( loadAcquire(_head) == tail ) {
+        return -1;
+      }
+      *data = _buffer[tail & MASK];
+      storeRelease(_tail, tail + 1);
+      return 0;
+    }
+
+    /*!
+     * @brief Consumer: remove up to n of the oldest elements, releasing
+     * their slots all at once
+     * @return uint16_t the number of elements removed
+     */
+    uint16_t takeN(T* data, uint16_t n) {
+      const Index tail = loadRelaxed(_tail);
+      const uint16_t ready = (Index)(loadAcquire(_head) - tail);
+      if( n > ready ) {
+        n = ready;
+      }
+      for( uint16_t i = 0; i < n; ++i ) {
+        data[i] = _buffer[(Index)(tail + i) & MASK];
+      }
+      storeRelease(_tail, tail + n);
+      return n;
+    }
+
+    /*!
+     * @brief Consumer: read the oldest element without removing it
+     * @return int8_t 0 on success, -1 if the buffer is empty
+     */
+    int8_t peek(T* data) const {
+      const Index tail = loadRelaxed(_tail);
+      if( loadAcquire(_head) == tail ) {
+        return -1;
+      }
+      *data = _buffer[tail & MASK];
+      return 0;
+    }
+
+    /*!
+     * @return the number of elements in the buffer. Exact for the consumer,
+     * a lower bound of the free space for the producer
+     */
+    uint16_t count() const {
+      // read the tail first so the head can not be behind it
+      const Index tail = loadAcquire(_tail);
+      const uint16_t n = (Index)(loadAcquire(_head) - tail);
+      return (n > LENGTH) ? LENGTH : n;
+    }
+    uint16_t available() const { return LENGTH - count(); }
+    uint16_t size() const { return LENGTH; }
+    bool isEmpty() const { return count() == 0; }
+    bool isFull() const { return count() >= LENGTH; }
+
+    /*!
+     * @brief Consumer: discard all elements. Safe while the producer is running
+     */
+    void clear() {
+      storeRelease(_tail, loadAcquire(_head));
+    }
+};
+
+#endif // End __SPSC_RING_H__ include guard
@@ -2,13 +2,14 @@
 #define __TIMER_H__
 
 #include "../devices/device.h"
+#include "delegate.h"
 
 typedef void(*voidCallback) ();
 
 class LT_Timer : public LT_Device {
   uint32_t _last_time = 0;
   uint32_t _timeout = 0;
-  voidCallback _callback = nullptr;
+  LT::Delegate<void()> _callback;
   bool _isSingleShot = false;
   bool _isActive = true;
   
@@ -16,7 +17,7 @@ class LT_Timer : public LT_Device {
     LT_Timer(const uint8_t id, uint32_t timeout) : LT_Device(id), _timeout(timeout) {}
     
     LT::DeviceType type() const {return LT::Timer;}
-     void setCallback(voidCallback c) {
+     void setCallback(LT::Delegate<void()> c) {
       _callback = c;
     }
     
@@ -43,7 +44,7 @@ class LT_Timer : public LT_Device {
        if(_isActive) {
         if( (LT_current_time_us - _last_time) >= _timeout) {
             if (_callback != nullptr) {
-              (*_callback)();
+              _callback();
             }
             if(_isSingleShot) {
               _isActive = false;
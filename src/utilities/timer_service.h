@@ -0,0 +1,296 @@
+#ifndef __TIMER_SERVICE_H__
+#define __TIMER_SERVICE_H__
+
+#include "../devices/device.h"
+#include "delegate.h"
+
+/*!
+ * @file timer_service.h
+ *
+ * LT_TimerService runs many lightweight timers from one device. Each timer
+ * is a handle into a fixed pool, so timers do not use DeviceManager slots
+ * and idle timers cost nothing in the loop.
+ *
+ * Timers are kept in a hierarchical timing wheel. Level 0 has one slot per
+ * tick; each higher level has one slot per full turn of the level below.
+ * When a lower level wraps, the next slot of the level above is cascaded
+ * down. Starting and cancelling a timer is O(1), and each timer is moved at
+ * most LEVELS - 1 times before it expires.
+ *
+ * With the default 5 bits per level, 4 levels and a 1 ms tick, a timer
+ * can be up to 2^20 ticks (about 17 minutes) away in a single pass. Longer
+ * timers wait in the top level until they are in range.
+ *
+ * LT_TimerService<32> timers(device_manager.registerDevice());
+ * uint8_t watchdog = timers.create(onWatchdog); // void onWatchdog(int handle)
+ * timers.start(watchdog, 500000); // single shot in 500 ms
+ */
+
+/*!
+ * @tparam N_TIMERS the size of the timer pool (at most 254)
+ * @tparam SLOT_BITS each level of the wheel has 2^SLOT_BITS slots
+ * @tparam LEVELS the number of levels in the wheel
+ */
+template <uint8_t N_TIMERS, uint8_t SLOT_BITS = 5, uint8_t LEVELS = 4>
+class LT_TimerService : public LT_Device {
+  public:
+    static const uint8_t NO_TIMER = 0xFF; ///< returned by create() when the pool is empty
+
+  private:
+    static const uint8_t SLOTS = 1 << SLOT_BITS;
+    static const uint8_t MASK = SLOTS - 1;
+    static const uint8_t PENDING = LEVELS * SLOTS; ///< list of timers being expired or cascaded
+    static const uint8_t FREE = PENDING + 1; ///< list of unallocated timers
+    static const uint8_t IDLE = PENDING + 2; ///< _slot value of allocated timers that are not running
+    static const uint8_t NIL = 0xFF;
+
+    uint8_t _heads[LEVELS * SLOTS + 2]; ///< first timer in each wheel slot, the pending list and the free list
+    uint8_t _next[N_TIMERS]; ///< next timer in the same list
+    uint8_t _prev[N_TIMERS]; ///< previous timer in the same list, NIL for the first timer
+    uint8_t _slot[N_TIMERS]; ///< the list that each timer is in
+    uint32_t _expiry[N_TIMERS]; ///< the tick that each timer expires on
+    uint32_t _period[N_TIMERS]; ///< the period of each timer in ticks, 0 for single shot
+    LT::Delegate<void(int)> _callbacks[N_TIMERS]; ///< called with the timer handle when it expires
+
+    uint32_t _tick_us; ///< the length of a tick in microseconds
+    uint32_t _now = 0; ///< the next tick to be processed
+    uint32_t _t_last = 0; ///< the system time in microseconds at the start of tick _now
+    uint8_t _active = 0; ///< the number of running timers
+
+    void link(const uint8_t i, const uint8_t list) {
+      _slot[i] = list;
+      _prev[i] = NIL;
+      _next[i] = _heads[list];
+      if( _next[i] != NIL ) {
+        _prev[_next[i]] = i;
+      }
+      _heads[list] = i;
+    }
+
+    void unlink(const uint8_t i) {
+      if( _prev[i] != NIL ) {
+        _next[_prev[i]] = _next[i];
+      }
+      else {
+        _heads[_slot[i]] = _next[i];
+      }
+      if( _next[i] != NIL ) {
+        _prev[_next[i]] = _prev[i];
+      }
+    }
+
+    // place a timer in the wheel slot for its expiry tick
+    void schedule(const uint8_t i) {
+      const uint32_t expiry = _expiry[i];
+      uint32_t delta = expiry - _now;
+      if( (int32_t)delta < 0 ) {
+        delta = 0;
+      }
+      uint8_t level = 0;
+      while( level < LEVELS - 1 && delta >= (1UL << (SLOT_BITS * (level + 1))) ) {
+        ++level;
+      }
+      uint32_t place = expiry;
+      if( delta >= (1UL << (SLOT_BITS * LEVELS)) ) {
+        // out of range: wait in the last top level slot to be visited
+        place = _now + (1UL << (SLOT_BITS * LEVELS)) - 1;
+      }
+      else if( delta == 0 ) {
+        place = _now;
+      }
+      link(i, level * SLOTS + ((place >> (SLOT_BITS * level)) & MASK));
+    }
+
+    // empty a slot. Level 0 timers expire, higher level timers move down
+    void runSlot(const uint8_t slot, const bool expire) {
+      // move the slot to the pending list first, so callbacks can
+      // start and cancel any timer, including the ones in this slot
+      _heads[PENDING] = _heads[slot];
+      _heads[slot] = NIL;
+      for( uint8_t i = _heads[PENDING]; i != NIL; i = _next[i] ) {
+        _slot[i] = PENDING;
+      }
+      uint8_t i;
+      while( (i = _heads[PENDING]) != NIL ) {
+        unlink(i);
+        if( !expire ) {
+          schedule(i);
+        }
+        else {
+          if( _period[i] > 0 ) {
+            _expiry[i] += _period[i];
+            schedule(i);
+          }
+          else {
+            _slot[i] = IDLE;
+            _active--;
+          }
+          if( _callbacks[i] != nullptr ) {
+            _callbacks[i](i);
+          }
+        }
+      }
+    }
+
+    void tick() {
+      const uint8_t index = _now & MASK;
+      if( index == 0 ) {
+        for( uint8_t level = 1; level < LEVELS; ++level ) {
+          const uint8_t cascade = (_now >> (SLOT_BITS * level)) & MASK;
+          runSlot(level * SLOTS + cascade, false);
+          if( cascade != 0 ) break;
+        }
+      }
+      // timers started by the callbacks are measured from the next tick
+      _now++;
+      runSlot(index, true);
+    }
+
+    bool valid(const uint8_t handle) const {
+      return ( handle < N_TIMERS && _slot[handle] != FREE );
+    }
+
+  public:
+    /*!
+     * @param id the unique id of the device
+     * @param tick_us the resolution of the timers in microseconds
+     */
+    LT_TimerService(const uint8_t id, const uint32_t tick_us = 1000)
+    : LT_Device(id), _tick_us(tick_us ? tick_us : 1)
+    {
+      static_assert(N_TIMERS > 0 && N_TIMERS < NIL, "LT_TimerService can have 1 to 254 timers");
+      static_assert(LEVELS * SLOTS + 2 < NIL, "LT_TimerService wheel has too many slots");
+      static_assert(SLOT_BITS * LEVELS <= 31, "LT_TimerService wheel range must fit in 31 bits");
+      for( uint8_t s = 0; s < LEVELS * SLOTS + 2; ++s ) {
+        _heads[s] = NIL;
+      }
+      for( uint8_t i = N_TIMERS; i > 0; --i ) {
+        _callbacks[i - 1] = nullptr;
+        link(i - 1, FREE);
+      }
+    }
+
+    LT::DeviceType type() const { return LT::Timer; }
+
+    LT_TimerService* instance() { return this; }
+
+    void begin() {
+      _t_last = LT_current_time_us;
+    }
+
+    /*!
+     * @brief take a timer from the pool
+     *
+     * @param callback called with the timer handle each time the timer expires
+     * @return uint8_t the timer handle, or NO_TIMER if the pool is empty
+     */
+    uint8_t create(LT::Delegate<void(int)> callback) {
+      const uint8_t i = _heads[FREE];
+      if( i == NIL ) return NO_TIMER;
+      unlink(i);
+      _slot[i] = IDLE;
+      _callbacks[i] = callback;
+      return i;
+    }
+
+    /*!
+     * @brief stop a timer and return it to the pool
+     */
+    void destroy(const uint8_t handle) {
+      if( !valid(handle) ) return;
+      cancel(handle);
+      _callbacks[handle] = nullptr;
+      link(handle, FREE);
+    }
+
+    /*!
+     * @brief start or restart a timer
+     *
+     * @param handle the timer handle from create()
+     * @param delay_us the time in microseconds until the first expiry.
+     * The timer never expires early, and is late by at most one tick
+     * @param period_us the time in microseconds between later expiries,
+     * rounded to the nearest tick. 0 makes a single shot timer
+     * @return true if the handle is valid
+     */
+    bool start(const uint8_t handle, const uint32_t delay_us, const uint32_t period_us = 0) {
+      if( !valid(handle) ) return false;
+      cancel(handle);
+      const uint32_t elapsed = LT_current_time_us - _t_last;
+      // tick _now ends at _t_last + _tick_us
+      const uint32_t ticks = (elapsed + delay_us + _tick_us - 1) / _tick_us;
+      _expiry[handle] = _now + ticks - 1;
+      _period[handle] = (period_us == 0) ? 0 : (period_us + _tick_us / 2) / _tick_us;
+      if( period_us > 0 && _period[handle] == 0 ) {
+        _period[handle] = 1;
+      }
+      schedule(handle);
+      _active++;
+      return true;
+    }
+
+    /*!
+     * @brief stop a timer. The handle stays allocated
+     */
+    void cancel(const uint8_t handle) {
+      if( !isActive(handle) ) return;
+      unlink(handle);
+      _slot[handle] = IDLE;
+      _active--;
+    }
+
+    bool isActive(const uint8_t handle) const {
+      return ( valid(handle) && _slot[handle] != IDLE );
+    }
+
+    /*!
+     * @return uint32_t the time in microseconds until the timer expires,
+     * or 0 if it is not running
+     */
+    uint32_t remaining(const uint8_t handle) const {
+      if( !isActive(handle) ) return 0;
+      const uint32_t end = _t_last + (_expiry[handle] - _now + 1) * _tick_us;
+      const uint32_t left = end - LT_current_time_us;
+      return ((int32_t)left > 0) ? left : 0;
+    }
+
+    void setCallback(const uint8_t handle, LT::Delegate<void(int)> callback) {
+      if( valid(handle) ) {
+        _callbacks[handle] = callback;
+      }
+    }
+
+    /*!
+     * @return the number of timers that are running
+     */
+    uint8_t activeCount() const { return _active; }
+
+    /*!
+     * @return the number of timers left in the pool
+     */
+    uint8_t available() const {
+      uint8_t n = 0;
+      for( uint8_t i = _heads[FREE]; i != NIL; i = _next[i] ) {
+        ++n;
+      }
+      return n;
+    }
+
+    uint32_t getTick() const { return _tick_us; }
+
+    void update() {
+      if( _active == 0 ) {
+        // nothing to expire: skip ahead to the current tick
+        const uint32_t ticks = (LT_current_time_us - _t_last) / _tick_us;
+        _now += ticks;
+        _t_last += ticks * _tick_us;
+        return;
+      }
+      while( (LT_current_time_us - _t_last) >= _tick_us ) {
+        _t_last += _tick_us;
+        tick();
+      }
+    }
+};
+
+#endif //End __TIMER_SERVICE_H__ include guard
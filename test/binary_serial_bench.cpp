@@ -0,0 +1,130 @@
+// BinarySerial throughput by frame size: the time to send a packet
+// (checksum, escape and write) and to receive it (unescape, checksum and
+// callback), with SLIP and COBS framing. Packets are sent whole and as a
+// header followed by a payload, and a frame that fits in
+// BINARY_SERIAL_TX_BLOCK must take one write() either way. The framing
+// overhead is then compared for payloads that are worst for each framing.
+#include <Arduino.h>
+#include <random>
+#include <vector>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "messengers/binary_serial.h"
+
+// a stream that always has room, counts the writes and keeps what was
+// last written
+struct Sink : Stream {
+  std::vector<uint8_t> out;
+  bool keep = true;
+  uint32_t writes = 0;
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t *b, size_t n) override {
+    writes++;
+    if( keep ) out.insert(out.end(), b, b + n);
+    return n;
+  }
+  int availableForWrite() override { return 1 << 16; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+volatile uint32_t received;
+bool failed = false;
+
+// the packet is sent whole, or split after a 3 byte header
+template <LT::Framing FRAMING>
+void run(const char *name, const uint16_t size, const bool split) {
+  typedef BasicBinarySerial<1024, 0, FRAMING> Messenger;
+  std::vector<uint8_t> packet(size);
+  for( uint16_t i = 0; i < size; ++i ) packet[i] = (uint8_t)(i * 31 + 7); // includes the escaped values
+  packet[0] = LT::Read_Sensor_Value;
+
+  Sink tx_stream;
+  Messenger tx(tx_stream);
+  auto send = [&]() {
+    if( split ) {
+      tx.sendPacket(packet.data(), 3, packet.data() + 3, size - 3);
+    } else {
+      tx.sendPacket(packet.data(), size);
+    }
+  };
+  send();
+  std::vector<uint8_t> frame = tx_stream.out;
+  tx_stream.keep = false;
+
+  const uint32_t n = 4000000 / size;
+  tx_stream.writes = 0;
+  const double send_ns = benchNs([&](uint32_t) { send(); }, n);
+  if( frame.size() <= BINARY_SERIAL_TX_BLOCK && tx_stream.writes != n ) {
+    printf("%s %u: %u writes for %u frames\n", name, size, tx_stream.writes, n);
+    failed = true;
+  }
+
+  Sink rx_stream;
+  Messenger rx(rx_stream);
+  rx.setMessageReceivedCallback([](int length) { received += length; });
+  received = 0;
+  const double receive_ns = benchNs([&](uint32_t) {
+    rx.receive(frame.data(), frame.size());
+  }, n);
+  if( received != n * (size + 4u) ) {
+    printf("%s %u: frames were not received\n", name, size);
+    failed = true;
+  }
+
+  printf("  %-4s %-5s %5u %6u %6.1f %10.0f %7.1f %10.0f %7.1f\n", name, split ? "split" : "whole",
+    size, (unsigned)frame.size(), (double)tx_stream.writes / n,
+    send_ns, size * 1000.0 / send_ns, receive_ns, size * 1000.0 / receive_ns);
+}
+
+// the frame for a payload and the time to send it
+template <LT::Framing FRAMING>
+void overhead(const char *name, const std::vector<uint8_t> &payload) {
+  Sink stream;
+  BasicBinarySerial<1024, 0, FRAMING> tx(stream);
+  tx.sendPacket(payload.data(), payload.size());
+  const size_t frame = stream.out.size();
+  stream.keep = false;
+  const double send_ns = benchNs([&](uint32_t) {
+    tx.sendPacket(payload.data(), payload.size());
+  }, 4000000 / payload.size());
+  printf(" %s %6u %5.3f %7.0f", name, (unsigned)frame, (double)frame / payload.size(), send_ns);
+}
+
+void compare(const char *name, const std::vector<uint8_t> &payload) {
+  printf("  %-14s %5u", name, (unsigned)payload.size());
+  overhead<LT::Framing_SLIP>("", payload);
+  overhead<LT::Framing_COBS>("", payload);
+  printf("\n");
+}
+
+int main() {
+  printf("BinarySerial<1024>, per packet, %u byte transmit block\n", BINARY_SERIAL_TX_BLOCK);
+  printf("  framing packet size  frame writes    send ns    MB/s receive ns    MB/s\n");
+  const uint16_t sizes[] = {16, 64, 128, 256, 1000};
+  for( const bool split : {false, true} ) {
+    for( uint16_t size : sizes ) run<LT::Framing_SLIP>("SLIP", size, split);
+    for( uint16_t size : sizes ) run<LT::Framing_COBS>("COBS", size, split);
+  }
+
+  // SLIP doubles 0xC0 and 0xDB, COBS adds a byte per 254 zero free bytes
+  // and one per zero. The frame includes the delimiters and the checksum
+  printf("\nframe size against the payload\n");
+  printf("                        ------- SLIP -------  ------- COBS -------\n");
+  printf("  payload         size   frame ratio send ns   frame ratio send ns\n");
+  std::mt19937 random(1);
+  for( const uint16_t size : {254, 1000} ) {
+    std::vector<uint8_t> payload(size);
+    for( uint8_t &b : payload ) b = (uint8_t)random();
+    compare("random", payload);
+    for( uint16_t i = 0; i < size; ++i ) payload[i] = (i & 1) ? 0xDB : 0xC0;
+    compare("0xC0 and 0xDB", payload);
+    for( uint8_t &b : payload ) b = 0;
+    compare("0x00", payload);
+    for( uint16_t i = 0; i < size; ++i ) payload[i] = (uint8_t)(i % 255 + 1);
+    compare("zero free", payload);
+  }
+  return failed ? 1 : 0;
+}
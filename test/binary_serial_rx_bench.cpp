@@ -0,0 +1,91 @@
+// BinarySerial receive throughput through update(): a stream serves
+// queued frames through available() and readBytes(), so the rows include
+// the BINARY_SERIAL_RX_BLOCK reads, the receive budget checks and the
+// unescape loop, with SLIP and COBS framing.
+#include <Arduino.h>
+#include <vector>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "messengers/binary_serial.h"
+
+// a stream that keeps what is written, and serves `in` to the reader
+// no more than `fifo` bytes at a time, like a UART receive buffer
+struct Feed : Stream {
+  std::vector<uint8_t> out;
+  std::vector<uint8_t> in;
+  size_t position = 0;
+  size_t fifo = 256;
+  uint32_t reads = 0; ///< calls to readBytes()
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t *b, size_t n) override {
+    out.insert(out.end(), b, b + n);
+    return n;
+  }
+  int availableForWrite() override { return 1 << 16; }
+  int available() override {
+    const size_t left = in.size() - position;
+    return (int)((left < fifo) ? left : fifo);
+  }
+  int read() override { return (position < in.size()) ? in[position++] : -1; }
+  int peek() override { return (position < in.size()) ? in[position] : -1; }
+  size_t readBytes(uint8_t *buffer, size_t n) override {
+    reads++;
+    memcpy(buffer, &in[position], n);
+    position += n;
+    return n;
+  }
+};
+
+volatile uint32_t received;
+
+// the frames queued in the stream for each pass
+const uint16_t FRAMES = 64;
+
+template <LT::Framing FRAMING>
+void run(const char *name, const uint16_t size, const uint16_t budget) {
+  typedef BasicBinarySerial<1024, 0, FRAMING> Messenger;
+  std::vector<uint8_t> packet(size);
+  for( uint16_t i = 0; i < size; ++i ) packet[i] = (uint8_t)(i * 31 + 7); // includes the escaped values
+  packet[0] = LT::Read_Sensor_Value;
+
+  Feed stream;
+  Messenger serial(stream);
+  serial.sendPacket(packet.data(), size);
+  const std::vector<uint8_t> frame = stream.out;
+  for( uint16_t i = 0; i < FRAMES; ++i ) {
+    stream.in.insert(stream.in.end(), frame.begin(), frame.end());
+  }
+
+  serial.setMessageReceivedCallback([](int length) { received += length; });
+  serial.setReceiveBudget(budget);
+  received = 0;
+  uint32_t updates = 0;
+  const uint32_t n = 4000000 / stream.in.size() + 1;
+  const double pass_ns = benchNs([&](uint32_t) {
+    stream.position = 0;
+    while( stream.position < stream.in.size() ) {
+      serial.update();
+      updates++;
+    }
+  }, n);
+  if( received != n * FRAMES * (size + 4u) ) {
+    printf("%s %u: frames were not received\n", name, size);
+  }
+
+  printf("  %-4s %5u %6u %6u %12.0f %7.2f %11.1f %13.1f\n", name, size, (unsigned)frame.size(), budget,
+    FRAMES * 1e9 / pass_ns, pass_ns / stream.in.size(),
+    (double)stream.reads / (n * FRAMES), (double)updates / (n * FRAMES));
+}
+
+int main() {
+  printf("BinarySerial<1024>::update(), %u queued frames, 256 byte UART buffer\n", FRAMES);
+  printf("  framing size  frame budget     frames/s ns/byte reads/frame updates/frame\n");
+  const uint16_t sizes[] = {16, 64, 256, 1000};
+  const uint16_t budgets[] = {0, 64};
+  for( uint16_t budget : budgets ) {
+    for( uint16_t size : sizes ) run<LT::Framing_SLIP>("SLIP", size, budget);
+    for( uint16_t size : sizes ) run<LT::Framing_COBS>("COBS", size, budget);
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+// The BinarySerial transmit queue against a UART with limited room:
+// frames are queued and written in order as room appears, priority frames
+// go first, and frames larger than a lane are still sent.
+#include <Arduino.h>
+#include <vector>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "messengers/binary_serial.h"
+
+// a UART that has room for `room` bytes until the test adds more.
+// Writes past the room are counted, as a real UART would block on them
+struct Throttled : Stream {
+  std::vector<uint8_t> out;
+  int room = 0;
+  int blocked = 0; ///< bytes written with no room
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t *b, size_t n) override {
+    if( (int)n > room ) blocked += n - (room > 0 ? room : 0);
+    room -= n;
+    out.insert(out.end(), b, b + n);
+    return n;
+  }
+  int availableForWrite() override { return (room > 0) ? room : 0; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+typedef BasicBinarySerial<1024> Serial1k;
+
+// decodes what the transmitter wrote, keeping each message
+struct Receiver {
+  Throttled stream;
+  Serial1k serial;
+  std::vector<std::vector<uint8_t> > messages;
+  static Receiver *self;
+
+  Receiver() : serial(stream) {
+    self = this;
+    serial.setMessageReceivedCallback([](int n) {
+      self->messages.push_back(std::vector<uint8_t>(self->serial.messageData(), self->serial.messageData() + n - 4));
+    });
+  }
+  void receive(std::vector<uint8_t> &bytes) { serial.receive(bytes.data(), bytes.size()); bytes.clear(); }
+};
+Receiver *Receiver::self = nullptr;
+
+std::vector<uint8_t> message(const uint8_t code, const uint8_t tag, const uint16_t length) {
+  std::vector<uint8_t> m(length);
+  for( uint16_t i = 0; i < length; ++i ) m[i] = (uint8_t)(i * 7 + tag);
+  m[0] = code;
+  if( length > 1 ) m[1] = tag;
+  return m;
+}
+
+int main() {
+  Receiver rx;
+
+  // a frame larger than a lane is written even with 128 bytes of room
+  {
+    Throttled uart;
+    Serial1k tx(uart);
+    uart.room = 128;
+    const std::vector<uint8_t> big = message(LT::Read_Sensor_Value, 1, 1000);
+    CHECK_EQUAL(0, tx.sendPacket(big.data(), big.size()));
+    CHECK_EQUAL(0, tx.droppedPackets());
+    CHECK(uart.out.size() >= 1000 + 6);
+    rx.receive(uart.out);
+    CHECK_EQUAL(1, rx.messages.size());
+    CHECK(rx.messages.back() == big);
+  }
+
+  // queued frames go out in order as room appears, and a large frame
+  // waits for the frames queued before it
+  {
+    rx.messages.clear();
+    Throttled uart;
+    Serial1k tx(uart);
+    uart.room = 10;
+    std::vector<std::vector<uint8_t> > sent;
+    for( uint8_t i = 0; i < 4; ++i ) {
+      sent.push_back(message(LT::Read_Sensor_Value, i, 40));
+      CHECK_EQUAL(0, tx.sendPacket(sent.back().data(), sent.back().size()));
+    }
+    // part of the first frame is written, and the rest waits for room
+    CHECK_EQUAL(10, uart.out.size());
+    CHECK(tx.pendingBytes() > 0);
+    tx.update();
+    CHECK_EQUAL(10, uart.out.size());
+    sent.push_back(message(LT::Read_Sensor_Value, 4, 600));
+    CHECK_EQUAL(0, tx.sendPacket(sent.back().data(), sent.back().size()));
+    CHECK_EQUAL(0, tx.pendingBytes());
+    rx.receive(uart.out);
+    CHECK_EQUAL(sent.size(), rx.messages.size());
+    for( size_t i = 0; i < sent.size() && i < rx.messages.size(); ++i ) {
+      CHECK(rx.messages[i] == sent[i]);
+    }
+  }
+
+  // a trickle of room: nothing is written past it, acknowledgements
+  // overtake bulk frames that have not started, and nothing is lost
+  {
+    rx.messages.clear();
+    Throttled uart;
+    Serial1k tx(uart);
+    for( uint8_t i = 0; i < 5; ++i ) {
+      const std::vector<uint8_t> m = message(LT::Read_Sensor_Value, i, 40);
+      CHECK_EQUAL(0, tx.sendPacket(m.data(), m.size()));
+    }
+    tx.sendAcknowledge(LT::Read_ID);
+    for( int loops = 0; tx.pendingBytes() > 0 && loops < 1000; ++loops ) {
+      uart.room = 7;
+      tx.update();
+      rx.receive(uart.out);
+    }
+    CHECK_EQUAL(0, uart.blocked);
+    CHECK_EQUAL(6, rx.messages.size());
+    CHECK_EQUAL(LT::Acknowledge, rx.messages[0][0]);
+    for( uint8_t i = 0; i < 5 && i + 1u < rx.messages.size(); ++i ) {
+      CHECK_EQUAL(i, rx.messages[i + 1][1]);
+    }
+  }
+
+  // a full lane drops frames and counts them
+  {
+    Throttled uart;
+    Serial1k tx(uart);
+    const std::vector<uint8_t> m = message(LT::Read_Sensor_Value, 0, 40);
+    int dropped = 0;
+    for( int i = 0; i < 20; ++i ) {
+      dropped += (tx.sendPacket(m.data(), m.size()) != 0);
+    }
+    CHECK(dropped > 0);
+    CHECK_EQUAL(dropped, tx.droppedPackets());
+    CHECK(uart.out.empty());
+  }
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,35 @@
+// The CRC-32 methods of crc.h over message sized and larger buffers, and
+// the one byte step used by the delayed receive checksum. LT_CRC32_ROM
+// steps single bytes with the byte method's table.
+#include <stdio.h>
+#include "bench.h"
+#include "crc_methods.h"
+
+volatile uint32_t sink;
+
+int main() {
+  static uint8_t data[1024];
+  for( uint16_t i = 0; i < sizeof(data); ++i ) data[i] = (uint8_t)(i * 31 + 7);
+  const uint16_t sizes[] = {16, 64, 256, 1024};
+
+  printf("crc32(), ns per buffer (MB/s)\n");
+  printf("  method ");
+  for( uint16_t size : sizes ) printf("%16u", size);
+  printf("  step ns/byte\n");
+  for( const Crc32Method &method : crc32_methods ) {
+    printf("  %-7s", method.name);
+    for( uint16_t size : sizes ) {
+      const double ns = benchNs([&](uint32_t i) {
+        sink = method.crc32(data, size, i);
+      }, 20000000 / size);
+      printf("%9.1f (%4.0f)", ns, size * 1000.0 / ns);
+    }
+    uint32_t crc = 0;
+    const double step_ns = benchNs([&](uint32_t i) {
+      crc = method.step(crc, data[i & 1023]);
+    }, 20000000);
+    sink = crc;
+    printf("%14.2f\n", step_ns);
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+// Dispatch through LT::Delegate against the bare function pointers that
+// the callbacks used before. The callees are out of line and the callers
+// are read through volatile pointers, so every call is an indirect call.
+#include <stdint.h>
+#include "bench.h"
+#include "utilities/delegate.h"
+
+uint32_t total;
+
+__attribute__((noinline)) void add(int x) { total += x; }
+
+struct Counter {
+  uint32_t total = 0;
+  __attribute__((noinline)) void add(int x) { total += x; }
+};
+
+typedef void (*Function)(int);
+typedef LT::Delegate<void(int)> Callback;
+
+int main() {
+  const uint32_t N = 100000000;
+  Counter counter;
+
+  Function function = add;
+  Function volatile *function_ref = &function;
+  const double function_ns = benchNs([&](uint32_t i) { (*function_ref)(i); }, N);
+
+  Callback free_delegate = add;
+  Callback volatile *free_ref = &free_delegate;
+  const double free_ns = benchNs([&](uint32_t i) { (*(Callback *)free_ref)(i); }, N);
+
+  Callback member_delegate = Callback::member<Counter, &Counter::add>(&counter);
+  Callback volatile *member_ref = &member_delegate;
+  const double member_ns = benchNs([&](uint32_t i) { (*(Callback *)member_ref)(i); }, N);
+
+  // the old way to reach an object: a global and a free function that forwards
+  static Counter *global = &counter;
+  Function forward = [](int x) { global->add(x); };
+  Function volatile *forward_ref = &forward;
+  const double forward_ns = benchNs([&](uint32_t i) { (*forward_ref)(i); }, N);
+
+  printf("callback dispatch, ns per call\n");
+  printf("  function pointer             %6.2f\n", function_ns);
+  printf("  Delegate, free function      %6.2f\n", free_ns);
+  printf("  function pointer + global    %6.2f\n", forward_ns);
+  printf("  Delegate, member function    %6.2f\n", member_ns);
+  return (total == 0 || counter.total == 0);
+}
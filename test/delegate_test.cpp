@@ -0,0 +1,66 @@
+// LT::Delegate: free functions, lambdas, member and bound functions,
+// comparison, and the empty delegate made from a null object.
+#include "test.h"
+#include <stdint.h>
+#include "utilities/delegate.h"
+
+int last = 0;
+void setLast(int x) { last = x; }
+void setDouble(int x) { last = 2 * x; }
+
+struct Counter {
+  int total = 0;
+  void add(int x) { total += x; }
+  int get() const { return total; }
+};
+void addTwice(Counter *c, int x) { c->add(2 * x); }
+
+typedef LT::Delegate<void(int)> Callback;
+
+int main() {
+  Callback empty;
+  CHECK(empty == nullptr);
+  CHECK(!empty);
+
+  Callback f = setLast;
+  CHECK(f != nullptr);
+  f(3);
+  CHECK_EQUAL(3, last);
+  CHECK(f == Callback(setLast));
+  CHECK(f != Callback(setDouble));
+
+  Callback lambda = [](int x) { last = -x; };
+  lambda(4);
+  CHECK_EQUAL(-4, last);
+
+  Counter a, b;
+  Callback add_a = Callback::member<Counter, &Counter::add>(&a);
+  Callback add_b = Callback::member<Counter, &Counter::add>(&b);
+  add_a(5);
+  add_a(1);
+  add_b(7);
+  CHECK_EQUAL(6, a.total);
+  CHECK_EQUAL(7, b.total);
+  CHECK(add_a != add_b);
+  CHECK(add_a == (Callback::member<Counter, &Counter::add>(&a)));
+
+  LT::Delegate<int()> get_a = LT::Delegate<int()>::member<Counter, &Counter::get>((const Counter *)&a);
+  CHECK_EQUAL(6, get_a());
+
+  Callback twice = Callback::bind<Counter, addTwice>(&b);
+  twice(2);
+  CHECK_EQUAL(11, b.total);
+  CHECK(twice != add_b);
+
+  // a null object makes an empty delegate instead of one that calls a
+  // stub through the free function pointer
+  Counter *none = nullptr;
+  Callback null_member = Callback::member<Counter, &Counter::add>(none);
+  CHECK(null_member == nullptr);
+  CHECK(!null_member);
+  CHECK(null_member == empty);
+  Callback null_bound = Callback::bind<Counter, addTwice>(none);
+  CHECK(null_bound == nullptr);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,66 @@
+// LT_EventBus dispatch throughput: queued delivery to 1, 4 and 8
+// subscribers, immediate dispatch(), and typed topics.
+#include <Arduino.h>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "utilities/event_bus.h"
+
+struct Counter {
+  volatile int32_t sum = 0;
+  void onEvent(const LT::Event &e) { sum += e.value; }
+  void onValue(int32_t value) { sum += value; }
+};
+
+typedef LT::Topic<LT::Event_User, int32_t> Reading;
+typedef LT_EventBus<8, 64> Bus;
+
+// post a batch of 64 events and deliver them, per event
+double queued(const uint8_t subscribers) {
+  static Counter counter;
+  Bus bus(0);
+  for( uint8_t i = 0; i < subscribers; ++i ) {
+    bus.subscribe(LT::Event_NewData, LT::EventHandler::member<Counter, &Counter::onEvent>(&counter));
+  }
+  return benchNs([&](uint32_t) {
+    for( int32_t k = 0; k < 64; ++k ) bus.post(LT::Event_NewData, 0, k);
+    bus.update();
+  }, 100000) / 64;
+}
+
+int main() {
+  static Counter counter;
+  printf("event bus, ns per event\n");
+  const uint8_t counts[3] = {1, 4, 8};
+  for( uint8_t i = 0; i < 3; ++i ) {
+    const double ns = queued(counts[i]);
+    printf("  post + update, %u subscribers   %6.2f  (%5.2f per delivery)\n", counts[i], ns, ns / counts[i]);
+  }
+
+  Bus bus(0);
+  for( uint8_t i = 0; i < 4; ++i ) {
+    bus.subscribe(LT::Event_NewData, LT::EventHandler::member<Counter, &Counter::onEvent>(&counter));
+  }
+  LT::Event e = {LT::Event_NewData, 0, 0};
+  const double dispatch_ns = benchNs([&](uint32_t i) {
+    e.value = i;
+    bus.dispatch(e);
+  }, 10000000);
+  printf("  dispatch(), 4 subscribers       %6.2f\n", dispatch_ns);
+
+  Bus typed(1);
+  for( uint8_t i = 0; i < 4; ++i ) {
+    typed.subscribe<Reading, Counter, &Counter::onValue>(&counter);
+  }
+  const double typed_ns = benchNs([&](uint32_t) {
+    for( int32_t k = 0; k < 64; ++k ) typed.publish<Reading>(k);
+    typed.update();
+  }, 100000) / 64;
+  printf("  typed publish + update, 4 subs  %6.2f\n", typed_ns);
+
+  // the same 4 handlers called directly, for reference
+  const double direct_ns = benchNs([&](uint32_t i) {
+    for( uint8_t k = 0; k < 4; ++k ) counter.onValue(i);
+  }, 10000000);
+  printf("  4 direct calls                  %6.2f\n", direct_ns);
+  return 0;
+}
@@ -0,0 +1,31 @@
+// Typed topics that must not compile. make -C test compiles this file
+// once as it is, then once with each FAIL_ macro, which must fail.
+#include <Arduino.h>
+uint32_t LT_current_time_us;
+#include "utilities/event_bus.h"
+
+typedef LT::Topic<LT::Event_User, float> Temperature;
+
+void onTemperature(float) {}
+void onCount(int32_t) {}
+struct Large { int32_t a, b; };
+
+int main() {
+  LT_EventBus<4> bus(0);
+  bus.subscribe<Temperature, onTemperature>();
+  bus.publish<Temperature>(1.5f);
+#if defined(FAIL_HANDLER_TYPE)
+  // the handler does not take the value type of the topic
+  bus.subscribe<Temperature, onCount>();
+#endif
+#if defined(FAIL_VALUE_SIZE)
+  // the value does not fit in an event
+  typedef LT::Topic<LT::Event_User + 1, Large> Pair;
+  bus.publish<Pair>(Large());
+#endif
+#if defined(FAIL_VALUE_TYPE)
+  // the value does not convert to the value type of the topic
+  bus.publish<Temperature>("hot");
+#endif
+  return 0;
+}
@@ -0,0 +1,127 @@
+// LT_EventBus: fan-out, queueing from handlers, a full queue, unsubscribing
+// from a handler, publishers, and typed topics.
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "utilities/event_bus.h"
+
+typedef LT_EventBus<8, 16> Bus;
+Bus *bus;
+
+int deliveries[4];
+int32_t last_value;
+
+void first(const LT::Event &e) { deliveries[0]++; last_value = e.value; }
+void second(const LT::Event &) { deliveries[1]++; }
+
+// posts a follow up event, which waits for the next update()
+void reposter(const LT::Event &e) {
+  deliveries[2]++;
+  if( e.value < 3 ) bus->post(LT::Event_User, 0, e.value + 1);
+}
+
+void unsubscriber(const LT::Event &) {
+  deliveries[3]++;
+  bus->unsubscribe(LT::Event_ButtonPressed, first);
+}
+
+struct Logger {
+  int count = 0;
+  int32_t sum = 0;
+  void onEvent(const LT::Event &e) { count++; sum += e.value; }
+};
+
+typedef LT::Topic<LT::Event_User + 1, float> Temperature;
+typedef LT::Topic<LT::Event_User + 2, int16_t> Offset;
+
+float last_temperature;
+void onTemperature(float celsius) { last_temperature = celsius; }
+
+struct Display {
+  int16_t offset = 0;
+  int updates = 0;
+  void onOffset(int16_t value) { offset = value; updates++; }
+};
+
+int main() {
+  Bus b(0);
+  bus = &b;
+  Logger logger;
+
+  // every subscriber of the topic and of Event_Any, in subscription order
+  CHECK_EQUAL(0, b.subscribe(LT::Event_NewData, first));
+  CHECK_EQUAL(0, b.subscribe(LT::Event_Any, LT::EventHandler::member<Logger, &Logger::onEvent>(&logger)));
+  CHECK_EQUAL(0, b.subscribe(LT::Event_NewData, second));
+  CHECK_EQUAL(-1, b.subscribe(LT::Event_None, second));
+  CHECK_EQUAL(0, b.post(LT::Event_NewData, 2, 5));
+  CHECK_EQUAL(0, b.post(LT::Event_Error, 2, 7));
+  CHECK_EQUAL(2, b.pending());
+  CHECK_EQUAL(0, deliveries[0]);
+  b.update();
+  CHECK_EQUAL(0, b.pending());
+  CHECK_EQUAL(1, deliveries[0]);
+  CHECK_EQUAL(1, deliveries[1]);
+  CHECK_EQUAL(5, last_value);
+  CHECK_EQUAL(2, logger.count);
+  CHECK_EQUAL(12, logger.sum);
+
+  // a full queue drops events and counts them
+  for( int i = 0; i < 20; ++i ) b.post(LT::Event_Error);
+  CHECK_EQUAL(16, b.pending());
+  CHECK_EQUAL(4, b.dropped());
+  b.update();
+
+  // events posted by a handler are delivered in the next update()
+  b.subscribe(LT::Event_User, reposter);
+  b.post(LT::Event_User, 0, 0);
+  int rounds = 0;
+  while( b.pending() ) {
+    b.update();
+    rounds++;
+  }
+  CHECK_EQUAL(4, rounds);
+  CHECK_EQUAL(4, deliveries[2]);
+
+  // a handler can unsubscribe another during delivery
+  b.subscribe(LT::Event_ButtonPressed, first);
+  b.subscribe(LT::Event_ButtonPressed, unsubscriber);
+  CHECK_EQUAL(6, b.subscriberCount());
+  const int before = deliveries[0];
+  b.post(LT::Event_ButtonPressed);
+  b.post(LT::Event_ButtonPressed);
+  b.update();
+  CHECK_EQUAL(1, deliveries[0] - before);
+  CHECK_EQUAL(2, deliveries[3]);
+  CHECK_EQUAL(5, b.subscriberCount());
+  CHECK_EQUAL(-1, b.unsubscribe(LT::Event_ButtonPressed, first));
+
+  // publishers post a fixed topic and source from a device callback
+  LT::Delegate<void()> pressed = b.publisher<LT::Event_NewData, 9>();
+  LT::Delegate<void(int)> started = b.valuePublisher<LT::Event_CommandStarted, 3>();
+  pressed();
+  started(42);
+  const int32_t sum = logger.sum;
+  b.update();
+  CHECK_EQUAL(42, logger.sum - sum);
+  CHECK_EQUAL(0, last_value);
+
+  // typed topics deliver the value in its own type
+  Display display;
+  Bus typed(1);
+  CHECK_EQUAL(0, (typed.subscribe<Temperature, onTemperature>()));
+  CHECK_EQUAL(0, (typed.subscribe<Offset, Display, &Display::onOffset>(&display)));
+  CHECK_EQUAL(0, typed.publish<Temperature>(21.5f, 4));
+  CHECK_EQUAL(0, typed.publish<Offset>(-1234));
+  typed.update();
+  CHECK(last_temperature == 21.5f);
+  CHECK_EQUAL(-1234, display.offset);
+  CHECK_EQUAL(0, (typed.unsubscribe<Offset, Display, &Display::onOffset>(&display)));
+  CHECK_EQUAL(-1, (typed.unsubscribe<Offset, Display, &Display::onOffset>(&display)));
+  typed.publish<Offset>(7);
+  typed.update();
+  CHECK_EQUAL(1, display.updates);
+  CHECK_EQUAL(0, (typed.unsubscribe<Temperature, onTemperature>()));
+  CHECK_EQUAL(0, typed.subscriberCount());
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,37 @@
+// Pin writes through FastPin on the simulated port array against
+// digitalWrite() of the host shim and LT_Pin. On a PC both are plain
+// stores, so this shows that FastPin adds no overhead over a direct
+// write. The gain over digitalWrite()'s table lookups is on AVR.
+#define LT_SIMULATED_PINS
+#include <Arduino.h>
+#include "bench.h"
+#include "utilities/fast_pin.h"
+
+int main() {
+  const uint32_t N = 50000000;
+  const LT_Pin pin(9);
+
+  const double digital_write_ns = benchNs([](uint32_t i) {
+    digitalWrite(9, i & 1);
+  }, N);
+  const double lt_pin_ns = benchNs([&](uint32_t i) {
+    pin.write(i & 1);
+  }, N);
+  const double fast_write_ns = benchNs([](uint32_t i) {
+    FastPin<9>::write(i & 1);
+  }, N);
+  const double fast_toggle_ns = benchNs([](uint32_t) {
+    FastPin<9>::toggle();
+  }, N);
+  const double lt_pin_toggle_ns = benchNs([&](uint32_t) {
+    pin.toggle();
+  }, N);
+
+  printf("pin write, ns per call\n");
+  printf("  digitalWrite(pin, value)   %6.2f\n", digital_write_ns);
+  printf("  LT_Pin::write(value)       %6.2f\n", lt_pin_ns);
+  printf("  FastPin<9>::write(value)   %6.2f\n", fast_write_ns);
+  printf("  LT_Pin::toggle()           %6.2f\n", lt_pin_toggle_ns);
+  printf("  FastPin<9>::toggle()       %6.2f\n", fast_toggle_ns);
+  return 0;
+}
@@ -0,0 +1,69 @@
+// FastPin on the simulated port array: each call reaches its own pin and
+// no other, and the device classes accept FastPin as their pin type.
+#define LT_SIMULATED_PINS
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/digital_output.h"
+#include "devices/stepper.h"
+
+// the number of simulated pins that are high
+int highPins() {
+  int n = 0;
+  for( uint16_t i = 0; i < 256; ++i ) n += ( LT::simulatedPins()[i] & 1 );
+  return n;
+}
+
+int main() {
+  volatile uint8_t *pins = LT::simulatedPins();
+
+  FastPin<7>::write(HIGH);
+  CHECK_EQUAL(1, pins[7]);
+  CHECK_EQUAL(HIGH, FastPin<7>::read());
+  CHECK_EQUAL(1, highPins());
+  FastPin<8>::high();
+  CHECK_EQUAL(HIGH, FastPin<8>::read());
+  FastPin<7>::toggle();
+  CHECK_EQUAL(LOW, FastPin<7>::read());
+  CHECK_EQUAL(HIGH, FastPin<8>::read());
+  FastPin<8>::toggle();
+  CHECK_EQUAL(0, highPins());
+  FastPin<255>::write(HIGH);
+  CHECK_EQUAL(1, pins[255]);
+  FastPin<255>::low();
+  CHECK_EQUAL(0, highPins());
+  CHECK_EQUAL(42, FastPin<42>::number());
+  // the Arduino pins are not touched
+  for( uint16_t i = 0; i < 256; ++i ) CHECK_EQUAL(0, host_pins[i]);
+
+  // LT_Pin still goes through digitalWrite()
+  LT_Pin pin(7);
+  pin.high();
+  CHECK_EQUAL(HIGH, host_pins[7]);
+  CHECK_EQUAL(0, highPins());
+  pin.low();
+
+  LT_BasicDigitalOutput< FastPin<9> > valve(1);
+  valve.begin();
+  valve.setValue(HIGH);
+  CHECK_EQUAL(1, pins[9]);
+  CHECK_EQUAL(1, highPins());
+  valve.setValue(LOW);
+  CHECK_EQUAL(0, pins[9]);
+
+  LT_BasicStepper< FastPin<2>, FastPin<5> > motor(2);
+  motor.begin();
+  CHECK_EQUAL(LOW, FastPin<2>::read());
+  CHECK_EQUAL(HIGH, FastPin<5>::read()); // forward
+  motor.beginPulse();
+  CHECK_EQUAL(HIGH, FastPin<2>::read());
+  CHECK_EQUAL(1, motor.getPosition());
+  motor.endPulse();
+  CHECK_EQUAL(LOW, FastPin<2>::read());
+  motor.setDirection(false);
+  CHECK_EQUAL(LOW, FastPin<5>::read());
+  CHECK_EQUAL(0, highPins());
+  for( uint16_t i = 0; i < 256; ++i ) CHECK_EQUAL(0, host_pins[i]);
+
+  return TEST_RESULT();
+}
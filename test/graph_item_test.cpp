@@ -0,0 +1,53 @@
+// GraphItem draws every graph type from a partly filled and a wrapped
+// data set, and labels the newest point.
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/sensor.h"
+#include "ui/graph_item.h"
+
+// the axes print the x label and the bounds of both axes
+const uint16_t AXES_PRINTS = 5;
+
+int main() {
+  U8G2 display;
+  UiContext context(&display);
+  GraphItem<float, 16> graph(nullptr);
+  graph.setLabelLastPoint(true);
+
+  // an empty graph draws the axes and no label
+  display.prints = 0;
+  graph.draw(&context);
+  CHECK_EQUAL(AXES_PRINTS, display.prints);
+
+  for( int i = 0; i < 10; ++i ) {
+    graph.addDataPoint(i, i % 7);
+  }
+  for( uint8_t type = LT::ScatterGraph; type <= LT::LineGraph; ++type ) {
+    graph.setGraphType(type);
+    display.prints = 0;
+    graph.draw(&context);
+    CHECK_EQUAL(AXES_PRINTS + 1, display.prints);
+    CHECK_EQUAL(9 % 7, display.printed);
+  }
+
+  // past the end of the buffer, the oldest points are overwritten
+  for( int i = 10; i < 40; ++i ) {
+    graph.addDataPoint(i, i % 7);
+  }
+  CHECK_EQUAL(16, graph.getDataSet().count());
+  CHECK_EQUAL(24, graph.getDataSet().xMin());
+  CHECK_EQUAL(39, graph.getDataSet().xMax());
+  for( uint8_t type = LT::ScatterGraph; type <= LT::LineGraph; ++type ) {
+    graph.setGraphType(type);
+    graph.draw(&context);
+    CHECK_EQUAL(39 % 7, display.printed);
+  }
+
+  graph.setLabelLastPoint(false);
+  display.prints = 0;
+  graph.draw(&context);
+  CHECK_EQUAL(AXES_PRINTS, display.prints);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,106 @@
+/*!
+ * A minimal Arduino core for building the library's headers on a PC.
+ * Only what the headers under test use is provided. Pins are an array,
+ * micros() is a variable the test sets, and Serial ports are replaced
+ * by Stream objects in the tests.
+ *
+ * Each test is a single translation unit, so the state is defined here.
+ */
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+// the binary constants of the core's binary.h that the library uses
+#define B111 7
+#define B111000 56
+#define PROGMEM
+#define F(x) (x)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+volatile uint8_t host_pins[256];  ///< the value last written to each pin, volatile like a port register
+uint32_t host_micros;    ///< the value returned by micros()
+bool host_interrupts = true;    ///< false between noInterrupts() and interrupts()
+uint32_t host_pin_writes;       ///< the number of calls to digitalWrite()
+uint32_t host_unlocked_writes;  ///< calls to digitalWrite() with interrupts enabled
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  host_pins[pin] = value;
+  host_pin_writes++;
+  host_unlocked_writes += host_interrupts;
+}
+inline int digitalRead(uint8_t pin) { return host_pins[pin]; }
+inline void analogWrite(uint8_t, int) {}
+inline int analogRead(uint8_t) { return 0; }
+inline void tone(uint8_t, unsigned) {}
+inline void noTone(uint8_t) {}
+inline unsigned long micros() { return host_micros; }
+inline unsigned long millis() { return host_micros / 1000; }
+inline void delay(unsigned long) {}
+inline void noInterrupts() { host_interrupts = false; }
+inline void interrupts() { host_interrupts = true; }
+inline long random(long a) { return rand() % a; }
+inline long random(long a, long b) { return a + rand() % (b - a); }
+template <class T> T constrain(T x, T a, T b) { return x < a ? a : (x > b ? b : x); }
+template <class T> T min(T a, T b) { return a < b ? a : b; }
+template <class T> T max(T a, T b) { return a > b ? a : b; }
+
+class __FlashStringHelper;
+
+class Print {
+  public:
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t n) {
+      size_t written = 0;
+      while( n-- ) written += write(*buffer++);
+      return written;
+    }
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    virtual int availableForWrite() { return 0; }
+    template <class T> size_t print(T, int = DEC) { return 0; }
+    template <class T> size_t println(T, int = DEC) { return 0; }
+    size_t println() { return 0; }
+    virtual ~Print() {}
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t readBytes(uint8_t *buffer, size_t n) {
+      size_t i = 0;
+      while( i < n ) {
+        const int c = read();
+        if( c < 0 ) break;
+        buffer[i++] = c;
+      }
+      return i;
+    }
+    size_t readBytes(char *buffer, size_t n) { return readBytes((uint8_t *)buffer, n); }
+    void setTimeout(unsigned long) {}
+};
+
+class String {
+  public:
+    String(const char * = "") {}
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*!
+ * A U8G2 display for building the ui headers on a PC. Drawing calls do
+ * nothing, except that the cursor and the last number printed are kept
+ * so a test can check what a graphics item wrote.
+ */
+#ifndef __HOST_U8G2LIB_H__
+#define __HOST_U8G2LIB_H__
+
+#include "Arduino.h"
+
+#define HOST_U8G2_IGNORE(name) template <class... A> int name(A...) { return 0; }
+
+class U8G2 {
+  public:
+    int cursor_x = 0;
+    int cursor_y = 0;
+    double printed = 0;    ///< the last number printed
+    uint16_t prints = 0;   ///< the number of calls to print()
+
+    void setCursor(int x, int y) { cursor_x = x; cursor_y = y; }
+    template <class T> size_t print(T value, int = DEC) { printed = value; prints++; return 0; }
+    size_t print(const char *) { prints++; return 0; }
+    int getDisplayWidth() { return 128; }
+    int getDisplayHeight() { return 64; }
+
+    HOST_U8G2_IGNORE(begin) HOST_U8G2_IGNORE(clear) HOST_U8G2_IGNORE(clearBuffer) HOST_U8G2_IGNORE(sendBuffer)
+    HOST_U8G2_IGNORE(firstPage) HOST_U8G2_IGNORE(nextPage) HOST_U8G2_IGNORE(setPowerSave) HOST_U8G2_IGNORE(setContrast)
+    HOST_U8G2_IGNORE(setFont) HOST_U8G2_IGNORE(setFontMode) HOST_U8G2_IGNORE(setFontDirection) HOST_U8G2_IGNORE(enableUTF8Print)
+    HOST_U8G2_IGNORE(setFontPosTop) HOST_U8G2_IGNORE(setFontPosBaseline) HOST_U8G2_IGNORE(setFontPosCenter)
+    HOST_U8G2_IGNORE(getAscent) HOST_U8G2_IGNORE(getDescent) HOST_U8G2_IGNORE(getFontAscent) HOST_U8G2_IGNORE(getFontDescent)
+    HOST_U8G2_IGNORE(getMaxCharHeight) HOST_U8G2_IGNORE(getMaxCharWidth) HOST_U8G2_IGNORE(getStrWidth) HOST_U8G2_IGNORE(getUTF8Width)
+    HOST_U8G2_IGNORE(getBufferTileHeight) HOST_U8G2_IGNORE(updateDisplay) HOST_U8G2_IGNORE(println)
+    HOST_U8G2_IGNORE(setDrawColor) HOST_U8G2_IGNORE(drawBox) HOST_U8G2_IGNORE(drawFrame) HOST_U8G2_IGNORE(drawRBox)
+    HOST_U8G2_IGNORE(drawRFrame) HOST_U8G2_IGNORE(drawLine) HOST_U8G2_IGNORE(drawHLine) HOST_U8G2_IGNORE(drawVLine)
+    HOST_U8G2_IGNORE(drawPixel) HOST_U8G2_IGNORE(drawStr) HOST_U8G2_IGNORE(drawUTF8) HOST_U8G2_IGNORE(drawGlyph)
+    HOST_U8G2_IGNORE(drawTriangle) HOST_U8G2_IGNORE(drawCircle) HOST_U8G2_IGNORE(drawDisc) HOST_U8G2_IGNORE(drawXBM)
+    HOST_U8G2_IGNORE(drawXBMP)
+};
+
+const uint8_t u8g2_font_helvB12_tr[1] = {0};
+const uint8_t u8g2_font_helvR08_tr[1] = {0};
+const uint8_t u8g2_font_tom_thumb_4x6_tr[1] = {0};
+const uint8_t u8g2_font_open_iconic_gui_1x_t[1] = {0};
+
+#endif
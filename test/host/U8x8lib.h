@@ -0,0 +1 @@
+#include "U8g2lib.h"
@@ -0,0 +1,26 @@
+/*!
+ * Timing for the host benchmarks. Results are for the PC the benchmark
+ * runs on, so compare the rows of one run, not the absolute numbers with
+ * a board.
+ */
+#ifndef __HOST_BENCH_H__
+#define __HOST_BENCH_H__
+
+#include <chrono>
+#include <stdio.h>
+
+/*!
+ * @brief call f(i) for i in [0, n) and return the time per call in ns.
+ * Store results in a volatile to keep the compiler from removing the work
+ */
+template <class F>
+double benchNs(F f, const uint32_t n) {
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for( uint32_t i = 0; i < n; ++i ) {
+    f(i);
+  }
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / n;
+}
+
+#endif
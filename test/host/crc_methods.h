@@ -0,0 +1,53 @@
+/*!
+ * crc.h compiled once for each table method, so a test or benchmark can
+ * compare them in one program. Each copy is in its own namespace:
+ * nibble::crc32(), byte::crc32(), slice4::crc32() and slice8::crc32().
+ */
+#ifndef __HOST_CRC_METHODS_H__
+#define __HOST_CRC_METHODS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace nibble {
+#undef __CRC_H__
+#undef LT_CRC32_METHOD
+#define LT_CRC32_METHOD 1
+#include "utilities/crc.h"
+}
+namespace byte {
+#undef __CRC_H__
+#undef LT_CRC32_METHOD
+#define LT_CRC32_METHOD 2
+#include "utilities/crc.h"
+}
+namespace slice4 {
+#undef __CRC_H__
+#undef LT_CRC32_METHOD
+#define LT_CRC32_METHOD 4
+#include "utilities/crc.h"
+}
+namespace slice8 {
+#undef __CRC_H__
+#undef LT_CRC32_METHOD
+#define LT_CRC32_METHOD 8
+#include "utilities/crc.h"
+}
+
+typedef uint32_t (*Crc32Function)(const uint8_t*, const size_t, const uint32_t);
+typedef uint32_t (*Crc32Step)(uint32_t, const uint8_t);
+
+struct Crc32Method {
+  const char *name;
+  Crc32Function crc32;
+  Crc32Step step; ///< LT::CRC32::step() for one byte
+};
+
+const Crc32Method crc32_methods[] = {
+  {"nibble", nibble::crc32, nibble::LT::CRC32::step},
+  {"byte", byte::crc32, byte::LT::CRC32::step},
+  {"slice4", slice4::crc32, slice4::LT::CRC32::step},
+  {"slice8", slice8::crc32, slice8::LT::CRC32::step}
+};
+
+#endif
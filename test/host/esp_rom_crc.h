@@ -0,0 +1,22 @@
+/*!
+ * A bitwise stand-in for the ESP32 ROM CRC routine, so crc.h can be
+ * built with LT_CRC32_METHOD set to LT_CRC32_ROM on a PC. Like the ROM,
+ * it takes and returns the inverted register.
+ */
+#ifndef __HOST_ESP_ROM_CRC_H__
+#define __HOST_ESP_ROM_CRC_H__
+
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  while( len-- ) {
+    crc ^= *buf++;
+    for( uint8_t k = 0; k < 8; ++k ) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+#endif
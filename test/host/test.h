@@ -0,0 +1,30 @@
+/*!
+ * Checks for the host tests. A failed CHECK prints where it failed and
+ * the test carries on, so one run reports every failure. main() ends
+ * with return TEST_RESULT();
+ */
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK(condition) do { \
+    if( !(condition) ) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      ++test_failures; \
+    } \
+  } while( 0 )
+
+#define CHECK_EQUAL(expected, actual) do { \
+    const long long e_ = (long long)(expected), a_ = (long long)(actual); \
+    if( e_ != a_ ) { \
+      printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+      ++test_failures; \
+    } \
+  } while( 0 )
+
+#define TEST_RESULT() ( printf("%s: %s\n", __FILE__, test_failures ? "FAIL" : "PASS"), test_failures ? 1 : 0 )
+
+#endif
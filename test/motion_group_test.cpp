@@ -0,0 +1,129 @@
+// LT_MotionGroup step counts, tick timing and junction blending on the
+// simulated step timer, and step counts when ticked from update().
+#define LT_SIMULATED_PINS
+#define LT_SIMULATED_TIMER
+#include <Arduino.h>
+#include <vector>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/motion_group.h"
+
+LT_Stepper x_motor(1, 2, 5);
+LT_Stepper y_motor(2, 3, 6);
+LT_MotionGroup<2> stage(3);
+
+// the timer owner: ticks the group and records the time of each step of each axis
+struct Probe {
+  std::vector<uint32_t> x, y;
+
+  uint32_t onStepTimer() {
+    const uint8_t x_before = host_pins[2], y_before = host_pins[3];
+    const uint32_t next = stage.onStepTimer();
+    if( !x_before && host_pins[2] ) x.push_back(LT_StepTimer::now());
+    if( !y_before && host_pins[3] ) y.push_back(LT_StepTimer::now());
+    return next;
+  }
+
+  void clear() { x.clear(); y.clear(); }
+
+  // the time from step i - 1 to step i of the x axis
+  uint32_t xInterval(const size_t i) const { return x[i] - x[i - 1]; }
+} probe;
+LT_STEP_TIMER_ISR(probe);
+
+void run() {
+  const uint32_t t_end = LT_StepTimer::now() + 10000000UL;
+  do {
+    LT_current_time_us = LT_StepTimer::now();
+    stage.update();
+    LT_StepTimer::advance(50);
+  } while( (stage.isMoving() || LT_StepTimer::isActive()) && LT_StepTimer::now() < t_end );
+}
+
+void queue(const int32_t x, const int32_t y, const float rate) {
+  const int32_t steps[2] = {x, y};
+  CHECK(stage.queueMove(steps, rate));
+}
+
+int main() {
+  x_motor.begin();
+  y_motor.begin();
+  stage.setAxis(0, &x_motor);
+  stage.setAxis(1, &y_motor);
+  CHECK(stage.setInterruptDriven(true));
+
+  // both axes start and finish together at a constant tick rate
+  queue(1600, -400, 4000);
+  run();
+  CHECK_EQUAL(1600, probe.x.size());
+  CHECK_EQUAL(400, probe.y.size());
+  CHECK_EQUAL(1600, x_motor.currentPosition());
+  CHECK_EQUAL(-400, y_motor.currentPosition());
+  // the minor axis steps halfway through each of its groups of major
+  // axis steps, so at most half a step from each end of the move
+  CHECK(probe.x.back() - probe.y.back() <= 250);
+  CHECK(probe.y.front() - probe.x.front() <= 2 * 250);
+  for( size_t i = 1; i < probe.x.size(); ++i ) {
+    CHECK_EQUAL(250, probe.xInterval(i));
+  }
+
+  // moves in a line blend at the full rate and the last move stops
+  stage.setAcceleration(50000);
+  probe.clear();
+  queue(1000, 0, 5000);
+  queue(1000, 0, 5000);
+  run();
+  CHECK_EQUAL(2000, probe.x.size());
+  CHECK(probe.xInterval(1) > 1000);
+  CHECK(probe.xInterval(2) < probe.xInterval(1));
+  CHECK_EQUAL(200, probe.xInterval(1000));
+  CHECK_EQUAL(200, probe.xInterval(1001));
+  CHECK(probe.xInterval(1999) > 1000);
+  CHECK(probe.xInterval(1998) < probe.xInterval(1999));
+  // a ramp from rest to 5000 steps/s at 50000 steps/s^2 takes 250 steps
+  CHECK(probe.xInterval(240) > 200);
+  CHECK_EQUAL(200, probe.xInterval(270));
+
+  // a right angle stops at the corner
+  probe.clear();
+  queue(1000, 0, 5000);
+  queue(0, 1000, 5000);
+  run();
+  CHECK_EQUAL(1000, probe.x.size());
+  CHECK_EQUAL(1000, probe.y.size());
+  CHECK(probe.xInterval(999) > 1000);
+  CHECK(probe.y[1] - probe.y[0] > 1000);
+  CHECK(probe.y[0] - probe.x.back() > 1000);
+
+  // a 45 degree turn slows to cos(45) of the rate, 283 us per step
+  probe.clear();
+  queue(1000, 0, 5000);
+  queue(1000, 1000, 5000);
+  run();
+  CHECK_EQUAL(2000, probe.x.size());
+  CHECK_EQUAL(1000, probe.y.size());
+  const uint32_t corner = probe.xInterval(1000);
+  CHECK(corner >= 270 && corner <= 300);
+  CHECK(probe.xInterval(500) == 200);
+  CHECK(probe.xInterval(1500) == 200);
+
+  // ticked from update()
+  CHECK(!stage.setInterruptDriven(false));
+  stage.setAcceleration(0);
+  x_motor.setPosition(0);
+  y_motor.setPosition(0);
+  queue(-300, 900, 2000);
+  queue(50, 50, 2000);
+  LT_current_time_us = 0;
+  uint32_t t = 0;
+  do {
+    LT_current_time_us += 10;
+    stage.update();
+  } while( stage.isMoving() && ++t < 100000 );
+  CHECK_EQUAL(-250, x_motor.currentPosition());
+  CHECK_EQUAL(950, y_motor.currentPosition());
+  // 950 ticks at 500 us each
+  CHECK(LT_current_time_us >= 950 * 500UL && LT_current_time_us < 950 * 500UL + 1000);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,46 @@
+// The ESP32 path of LT_OutputGroup: a pattern is one write to the GPIO
+// set register and one to the clear register, with the bit of each pin.
+#define ARDUINO_ARCH_ESP32
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+
+const uint32_t GPIO_OUT_W1TS_REG = 1;
+const uint32_t GPIO_OUT_W1TC_REG = 2;
+uint32_t set_writes, clear_writes;
+uint32_t set_mask, clear_mask;
+void REG_WRITE(const uint32_t reg, const uint32_t value) {
+  CHECK(!host_interrupts);
+  if( reg == GPIO_OUT_W1TS_REG ) { set_writes++; set_mask = value; }
+  if( reg == GPIO_OUT_W1TC_REG ) { clear_writes++; clear_mask = value; }
+}
+
+#include "devices/output_group.h"
+
+int main() {
+  LT_OutputGroup<4> valves(1);
+  CHECK_EQUAL(0, valves.setChannel(0, 2));
+  CHECK_EQUAL(0, valves.setChannel(1, 4));
+  CHECK_EQUAL(0, valves.setChannel(2, 16));
+  CHECK_EQUAL(0, valves.setChannel(3, 31));
+  CHECK_EQUAL(-1, valves.setChannel(3, 32));
+
+  set_writes = clear_writes = 0;
+  valves.setPattern(0x9);
+  CHECK_EQUAL(1, set_writes);
+  CHECK_EQUAL(1, clear_writes);
+  CHECK_EQUAL((1UL << 2) | (1UL << 31), set_mask);
+  CHECK_EQUAL((1UL << 4) | (1UL << 16), clear_mask);
+
+  // a mask that only sets pins skips the clear register
+  set_writes = clear_writes = 0;
+  valves.setPattern(0x6, 0x6);
+  CHECK_EQUAL(1, set_writes);
+  CHECK_EQUAL(0, clear_writes);
+  CHECK_EQUAL((1UL << 4) | (1UL << 16), set_mask);
+  CHECK_EQUAL(0xF, valves.getPattern());
+  CHECK(host_interrupts);
+  CHECK_EQUAL(0, host_pin_writes);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,92 @@
+// LT_OutputGroup on the digitalWrite() path: masked writes reach only
+// their channels with interrupts held off, and a queued sequence plays
+// back on time, repeats and stops.
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/output_group.h"
+
+const uint8_t PINS[4] = {3, 4, 10, 11};
+
+// the pattern on the pins of the group
+uint32_t pinPattern() {
+  uint32_t pattern = 0;
+  for( uint8_t i = 0; i < 4; ++i ) pattern |= (uint32_t)(host_pins[PINS[i]] & 1) << i;
+  return pattern;
+}
+
+int main() {
+  LT_OutputGroup<4> valves(1);
+  // a channel without a pin is skipped
+  valves.setPattern(0xF);
+  CHECK_EQUAL(0, host_pin_writes);
+  valves.setPattern(0);
+  for( uint8_t i = 0; i < 4; ++i ) CHECK_EQUAL(0, valves.setChannel(i, PINS[i]));
+  CHECK_EQUAL(-1, valves.setChannel(4, 12));
+
+  host_pin_writes = 0;
+  valves.setPattern(0x5);
+  CHECK_EQUAL(0x5, pinPattern());
+  CHECK_EQUAL(0x5, valves.getPattern());
+  CHECK_EQUAL(4, host_pin_writes);
+
+  // only the masked channels are written
+  host_pin_writes = 0;
+  valves.setPattern(0xA, 0x3);
+  CHECK_EQUAL(2, host_pin_writes);
+  CHECK_EQUAL(0x6, pinPattern());
+  CHECK_EQUAL(0x6, valves.getPattern());
+  valves.setValue(3, HIGH);
+  CHECK_EQUAL(0xE, pinPattern());
+  CHECK_EQUAL(1, valves.getValue(3));
+  CHECK_EQUAL(0, host_unlocked_writes);
+
+  // a sequence played twice, with each step measured from the scheduled
+  // end of the one before, even if update() runs late
+  CHECK(!valves.startSequence());
+  CHECK(valves.queuePattern(0x1, 100));
+  CHECK(valves.queuePattern(0x2, 200));
+  CHECK(valves.queuePattern(0x4, 300));
+  CHECK_EQUAL(3, valves.sequenceLength());
+  LT_current_time_us = 1000;
+  CHECK(valves.startSequence(2));
+  CHECK_EQUAL(0x1, pinPattern());
+  const struct { uint32_t t; uint32_t pattern; } expected[] = {
+    {1099, 0x1}, {1150, 0x2}, {1299, 0x2}, {1300, 0x4}, {1599, 0x4},
+    {1600, 0x1}, {1700, 0x2}, {1900, 0x4}, {2199, 0x4}
+  };
+  for( const auto &e : expected ) {
+    LT_current_time_us = e.t;
+    valves.update();
+    CHECK_EQUAL(e.pattern, pinPattern());
+    CHECK(valves.isRunning());
+  }
+  // after two plays the outputs hold the last pattern
+  LT_current_time_us = 2200;
+  valves.update();
+  CHECK(!valves.isRunning());
+  CHECK_EQUAL(0x4, pinPattern());
+  LT_current_time_us = 5000;
+  valves.update();
+  CHECK_EQUAL(0x4, pinPattern());
+
+  // 0 repeats until stopped
+  LT_current_time_us = 0;
+  CHECK(valves.startSequence(0));
+  for( LT_current_time_us = 0; LT_current_time_us < 6000; LT_current_time_us += 50 ) {
+    valves.update();
+  }
+  CHECK(valves.isRunning());
+  valves.stopSequence();
+  const uint32_t held = pinPattern();
+  LT_current_time_us += 1000;
+  valves.update();
+  CHECK_EQUAL(held, pinPattern());
+
+  valves.clearSequence();
+  CHECK_EQUAL(0, valves.sequenceLength());
+  CHECK_EQUAL(8, valves.available());
+  CHECK_EQUAL(0, host_unlocked_writes);
+
+  return TEST_RESULT();
+}
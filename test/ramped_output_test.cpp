@@ -0,0 +1,83 @@
+// LT_RampedOutput profiles on a simulated clock: a linear ramp follows
+// the line and arrives at the end of its duration, whatever the ratio of
+// the duration to the change.
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/ramped_output.h"
+
+LT_RampedOutput output(1, 9);
+
+// the largest distance from the ideal line over a linear ramp, with a
+// call to update() every 7 us
+int32_t linearError(const int32_t from, const int32_t to, const uint32_t duration) {
+  LT_current_time_us = 100000;
+  output.setValue(from);
+  output.rampTo(to, duration);
+  const uint32_t t_start = LT_current_time_us;
+  int32_t worst = 0;
+  for( ; LT_current_time_us - t_start < duration; LT_current_time_us += 7 ) {
+    output.update();
+    const double ideal = from + (double)(to - from) * (LT_current_time_us - t_start) / duration;
+    const double error = output.getValue() - ideal;
+    const int32_t e = (int32_t)(error >= 0 ? error + 0.999 : -error + 0.999);
+    if( e > worst ) worst = e;
+    if( !output.isRamping() ) return -1; // arrived early
+  }
+  LT_current_time_us = t_start + duration;
+  output.update();
+  CHECK_EQUAL(to, output.getValue());
+  CHECK(!output.isRamping());
+  return worst;
+}
+
+int main() {
+  // more change than microseconds: 600 units in 1 ms
+  CHECK_EQUAL(0, output.getValue());
+  output.rampTo(600, 1000);
+  LT_current_time_us = 500;
+  output.update();
+  CHECK_EQUAL(300, output.getValue());
+  LT_current_time_us = 999;
+  output.update();
+  CHECK_EQUAL(599, output.getValue());
+  CHECK(output.isRamping());
+  LT_current_time_us = 1000;
+  output.update();
+  CHECK_EQUAL(600, output.getValue());
+  CHECK(!output.isRamping());
+
+  // within one unit of the line, up and down, short and long
+  CHECK(linearError(0, 600, 1000) <= 1);
+  CHECK(linearError(600, 0, 1000) <= 1);
+  CHECK(linearError(0, 255, 100000) <= 1);
+  CHECK(linearError(-1000, 65535, 3000000) <= 1);
+  CHECK(linearError(4095, 17, 200000000UL) <= 1);
+
+  // a fixed rate of 1000 units/s
+  LT_current_time_us = 0;
+  output.setValue(0);
+  output.setRate(1000);
+  output.setTarget(100);
+  LT_current_time_us = 50000;
+  output.update();
+  CHECK_EQUAL(50, output.getValue());
+  LT_current_time_us = 100000;
+  output.update();
+  CHECK_EQUAL(100, output.getValue());
+  CHECK(!output.isRamping());
+
+  // an exponential ramp is ~63% there after a time constant and ends on time
+  LT_current_time_us = 0;
+  output.setValue(0);
+  output.rampTo(1000, 50000, LT::Ramp_Exponential);
+  LT_current_time_us = 10000;
+  output.update();
+  CHECK(output.getValue() > 600 && output.getValue() < 680);
+  LT_current_time_us = 50000;
+  output.update();
+  CHECK_EQUAL(1000, output.getValue());
+  CHECK(!output.isRamping());
+
+  return TEST_RESULT();
+}
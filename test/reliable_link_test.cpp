@@ -0,0 +1,184 @@
+// ReliableLink over a simulated cable that loses and corrupts writes:
+// every packet must arrive once and in order, in both directions. Also
+// checks that an ACK is not forgotten when the messenger drops the packet
+// that was to carry it, and that a lone ACK overtakes queued packets.
+#include <Arduino.h>
+#include <deque>
+#include <random>
+#include <vector>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "messengers/reliable_link.h"
+
+std::mt19937 rng(7);
+
+// one end of the cable. Each write() is one piece of a frame on the wire,
+// and is lost or has a bit flipped when the cable delivers it
+struct End : Stream {
+  std::vector<uint8_t> wire;  ///< written and not delivered yet
+  std::deque<uint8_t> in;     ///< delivered and not read yet
+  int room = 4096;
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t *b, size_t n) override {
+    wire.insert(wire.end(), b, b + n);
+    return n;
+  }
+  int availableForWrite() override { return room; }
+  int available() override { return in.size(); }
+  int read() override {
+    if( in.empty() ) return -1;
+    const uint8_t b = in.front();
+    in.pop_front();
+    return b;
+  }
+  int peek() override { return in.empty() ? -1 : in.front(); }
+
+  void deliver(End &to, const double loss, const double corrupt) {
+    std::uniform_real_distribution<double> chance(0, 1);
+    if( !wire.empty() && chance(rng) >= loss ) {
+      if( chance(rng) < corrupt ) {
+        wire[rng() % wire.size()] ^= 1u << (rng() % 8);
+      }
+      to.in.insert(to.in.end(), wire.begin(), wire.end());
+    }
+    wire.clear();
+  }
+};
+
+typedef ReliableLink<BinarySerial, 8> Link;
+
+// what one end received: the count in the first 4 bytes of each packet
+// must follow the previous one
+struct Counter {
+  Link *link = nullptr;
+  uint32_t expected = 0;
+  int errors = 0;
+  uint16_t length = 0;
+
+  void onMessage(int n) {
+    uint32_t count;
+    memcpy(&count, link->messageData(), 4);
+    errors += ( count != expected || n != length + 4 );
+    expected = count + 1;
+  }
+};
+
+/*!
+ * @brief send n packets each way over a cable that loses and corrupts
+ * writes, 100 us of simulated time per loop
+ * @return true if every packet arrived once and in order
+ */
+bool run(const double loss, const double corrupt, const uint32_t n) {
+  End a_end, b_end;
+  BinarySerial a_messenger(a_end), b_messenger(b_end);
+  Link a(a_messenger, 20000), b(b_messenger, 20000);
+  Counter at_a, at_b;
+  at_a.link = &a;
+  at_a.length = 20;
+  at_b.link = &b;
+  at_b.length = 32;
+  a.setMessageReceivedCallback(LT::Delegate<void(int)>::member<Counter, &Counter::onMessage>(&at_a));
+  b.setMessageReceivedCallback(LT::Delegate<void(int)>::member<Counter, &Counter::onMessage>(&at_b));
+
+  uint32_t sent_a = 0, sent_b = 0;
+  LT_current_time_us = 0;
+  for( uint32_t loops = 0; (at_a.expected < n || at_b.expected < n) && loops < 1000000; ++loops ) {
+    LT_current_time_us += 100;
+    uint8_t packet[32] = {0};
+    while( sent_a < n && a.available() ) {
+      memcpy(packet, &sent_a, 4);
+      CHECK_EQUAL(0, a.sendPacket(packet, at_b.length));
+      sent_a++;
+    }
+    while( sent_b < n && b.available() ) {
+      memcpy(packet, &sent_b, 4);
+      CHECK_EQUAL(0, b.sendPacket(packet, at_a.length));
+      sent_b++;
+    }
+    a_end.deliver(b_end, loss, corrupt);
+    b_end.deliver(a_end, loss, corrupt);
+    a_messenger.update();
+    b_messenger.update();
+    a.update();
+    b.update();
+  }
+  if( loss == 0 && corrupt == 0 ) {
+    CHECK_EQUAL(0, a.retransmissions());
+    CHECK_EQUAL(0, b.rejected());
+  }
+  else {
+    CHECK(a.retransmissions() > 0);
+  }
+  CHECK_EQUAL(0, at_a.errors);
+  CHECK_EQUAL(0, at_b.errors);
+  CHECK_EQUAL(n, at_a.expected);
+  CHECK_EQUAL(n, at_b.expected);
+  return ( at_a.errors == 0 && at_b.errors == 0 && at_a.expected == n && at_b.expected == n );
+}
+
+int main() {
+  CHECK(run(0, 0, 3000));
+  CHECK(run(0.05, 0, 3000));
+  CHECK(run(0.1, 0.05, 3000));
+  CHECK(run(0.3, 0.1, 1000));
+
+  // B's transmit queue is full when it receives a packet, so the packet it
+  // sends next is dropped by the messenger. The ACK it was to carry must
+  // still be sent on its own once there is room, before any timeout
+  {
+    End a_end, b_end;
+    BinarySerial a_messenger(a_end), b_messenger(b_end);
+    ReliableLink<BinarySerial, 16> a(a_messenger), b(b_messenger);
+    LT_current_time_us = 0;
+    uint8_t packet[8] = {LT::Read_Sensor_Value};
+
+    b_end.room = 0;
+    int dropped = 0;
+    while( dropped == 0 ) {
+      CHECK_EQUAL(0, b.sendPacket(packet, sizeof(packet)));
+      dropped = b_messenger.droppedPackets();
+    }
+    CHECK_EQUAL(0, a.sendPacket(packet, sizeof(packet)));
+    a_end.deliver(b_end, 0, 0);
+    b_messenger.update();
+    CHECK_EQUAL(0, b.sendPacket(packet, sizeof(packet)));
+    CHECK_EQUAL(dropped + 1, b_messenger.droppedPackets());
+
+    b_end.room = 4096;
+    b_messenger.update();
+    b.update();
+    b_end.deliver(a_end, 0, 0);
+    a_messenger.update();
+    CHECK_EQUAL(0, a.pending());
+  }
+
+  // B's packets wait in its transmit queue when it receives one from A.
+  // The lone ACK is written first once there is room for it alone
+  {
+    End a_end, b_end;
+    BinarySerial a_messenger(a_end), b_messenger(b_end);
+    Link a(a_messenger), b(b_messenger);
+    LT_current_time_us = 0;
+    uint8_t packet[8] = {LT::Read_Sensor_Value};
+
+    b_end.room = 0;
+    CHECK_EQUAL(0, b.sendPacket(packet, sizeof(packet)));
+    CHECK_EQUAL(0, b.sendPacket(packet, sizeof(packet)));
+    CHECK_EQUAL(0, a.sendPacket(packet, sizeof(packet)));
+    a_end.deliver(b_end, 0, 0);
+    b_messenger.update();
+    const uint16_t queued = b_messenger.pendingBytes();
+    b.update();
+    b_end.room = b_messenger.pendingBytes() - queued;
+    CHECK(b_end.room > 0);
+
+    b_messenger.update();
+    b_end.deliver(a_end, 0, 0);
+    a_messenger.update();
+    CHECK_EQUAL(0, a.pending());
+    CHECK_EQUAL(queued, b_messenger.pendingBytes());
+  }
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,90 @@
+// Reading every point of a full, wrapped 512 point DataSet: per-element
+// get() against the iterator and spans(), and a RingBuffer of the same
+// points read with get(), peekN() and spans(). The points are integers,
+// so the sum does not hide the cost of the access behind a chain of
+// float additions.
+#include <Arduino.h>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "devices/sensor.h"
+#include "ui/graph_item.h"
+
+const uint16_t POINTS = 512;
+typedef DataSet<POINTS, int32_t> Points;
+typedef RingBuffer<POINTS, DataPoint<int32_t> > Ring;
+
+volatile int32_t sink;
+
+int main() {
+  static Points data;
+  static Ring ring;
+  DataPoint<int32_t> taken;
+  for( uint16_t i = 0; i < POINTS + 200; ++i ) {
+    const DataPoint<int32_t> p(i, (i * 37) % 101);
+    data.push(p, &taken);
+    if( ring.isFull() ) ring.takeBack(&taken);
+    ring.put(p);
+  }
+  const uint32_t N = 100000;
+
+  const double get_ns = benchNs([&](uint32_t) {
+    int32_t sum = 0;
+    DataPoint<int32_t> p;
+    for( uint16_t i = 0; i < data.count(); ++i ) {
+      data.get(i, &p);
+      sum += p.y;
+    }
+    sink = sum;
+  }, N);
+  const double iterator_ns = benchNs([&](uint32_t) {
+    int32_t sum = 0;
+    for( const DataPoint<int32_t> &p : data ) sum += p.y;
+    sink = sum;
+  }, N);
+  const double spans_ns = benchNs([&](uint32_t) {
+    int32_t sum = 0;
+    Points::Span spans[2];
+    const uint8_t n = data.spans(&spans[0], &spans[1]);
+    for( uint8_t s = 0; s < n; ++s ) {
+      const DataPoint<int32_t> *p = spans[s].data;
+      for( uint16_t i = spans[s].length; i > 0; --i, ++p ) sum += p->y;
+    }
+    sink = sum;
+  }, N);
+
+  const double ring_get_ns = benchNs([&](uint32_t) {
+    int32_t sum = 0;
+    DataPoint<int32_t> p;
+    for( uint16_t i = 0; i < ring.count(); ++i ) {
+      ring.get(i, &p);
+      sum += p.y;
+    }
+    sink = sum;
+  }, N);
+  static DataPoint<int32_t> copy[POINTS];
+  const double peek_ns = benchNs([&](uint32_t) {
+    const uint16_t n = ring.peekN(copy, POINTS);
+    int32_t sum = 0;
+    for( uint16_t i = 0; i < n; ++i ) sum += copy[i].y;
+    sink = sum;
+  }, N);
+  const double ring_spans_ns = benchNs([&](uint32_t) {
+    int32_t sum = 0;
+    Ring::Span spans[2];
+    const uint8_t n = ring.spans(&spans[0], &spans[1]);
+    for( uint8_t s = 0; s < n; ++s ) {
+      const DataPoint<int32_t> *p = spans[s].data;
+      for( uint16_t i = spans[s].length; i > 0; --i, ++p ) sum += p->y;
+    }
+    sink = sum;
+  }, N);
+
+  printf("sum of y over a wrapped %u point buffer, ns per pass (speedup over get())\n", POINTS);
+  printf("  DataSet get()           %8.1f\n", get_ns);
+  printf("  DataSet iterator        %8.1f (%.1fx)\n", iterator_ns, get_ns / iterator_ns);
+  printf("  DataSet spans()         %8.1f (%.1fx)\n", spans_ns, get_ns / spans_ns);
+  printf("  RingBuffer get()        %8.1f\n", ring_get_ns);
+  printf("  RingBuffer peekN()      %8.1f (%.1fx)\n", peek_ns, ring_get_ns / peek_ns);
+  printf("  RingBuffer spans()      %8.1f (%.1fx)\n", ring_spans_ns, ring_get_ns / ring_spans_ns);
+  return 0;
+}
@@ -0,0 +1,115 @@
+// RingBuffer bulk access across the end of the storage: putN() with the
+// head past the end and more elements than room, peekN() from an index,
+// takeN(), and the two regions of spans(). Also OverwritingRingBuffer.
+#include <string.h>
+#include "test.h"
+#include "utilities/ring_buffer.h"
+
+typedef RingBuffer<8, int> Ring;
+
+// the elements of a ring from oldest to newest, through get()
+bool contains(const Ring &ring, const int *expected, const uint8_t n) {
+  if( ring.count() != n ) return false;
+  for( uint8_t i = 0; i < n; ++i ) {
+    int value;
+    if( ring.get(i, &value) != 0 || value != expected[i] ) return false;
+  }
+  return true;
+}
+
+int main() {
+  Ring ring;
+  int values[16];
+  for( int i = 0; i < 16; ++i ) values[i] = 100 + i;
+
+  // move the tail and head to offset 5
+  CHECK_EQUAL(5, ring.putN(values, 5));
+  int out[16];
+  CHECK_EQUAL(5, ring.takeN(out, 5));
+  CHECK(ring.isEmpty());
+
+  // 10 elements with room for 8: 3 before the end and 5 after it
+  CHECK_EQUAL(8, ring.putN(values, 10));
+  CHECK(ring.isFull());
+  CHECK(contains(ring, values, 8));
+  CHECK_EQUAL(0, ring.putN(values, 1));
+
+  // spans split at the end of the storage
+  Ring::Span first, second;
+  CHECK_EQUAL(2, ring.spans(&first, &second));
+  CHECK_EQUAL(3, first.length);
+  CHECK_EQUAL(5, second.length);
+  CHECK_EQUAL(100, first.data[0]);
+  CHECK_EQUAL(102, first.data[2]);
+  CHECK_EQUAL(103, second.data[0]);
+  CHECK_EQUAL(107, second.data[4]);
+
+  // peekN from an index before and after the split, and past the end
+  memset(out, 0, sizeof(out));
+  CHECK_EQUAL(4, ring.peekN(out, 4, 1));
+  const int from_1[] = {101, 102, 103, 104};
+  CHECK(memcmp(from_1, out, sizeof(from_1)) == 0);
+  CHECK_EQUAL(3, ring.peekN(out, 10, 5));
+  const int from_5[] = {105, 106, 107};
+  CHECK(memcmp(from_5, out, sizeof(from_5)) == 0);
+  CHECK_EQUAL(0, ring.peekN(out, 4, 8));
+  CHECK_EQUAL(8, ring.count());
+
+  // takeN across the split leaves the rest in order
+  CHECK_EQUAL(6, ring.takeN(out, 6));
+  CHECK(memcmp(values, out, 6 * sizeof(int)) == 0);
+  CHECK(contains(ring, values + 6, 2));
+  CHECK_EQUAL(1, ring.spans(&first, &second));
+  CHECK_EQUAL(2, first.length);
+  CHECK_EQUAL(0, second.length);
+  CHECK_EQUAL(2, ring.takeN(out, 8));
+  CHECK_EQUAL(0, ring.spans(&first, &second));
+
+  // 8-bit counters that wrap many times
+  RingBuffer<128, uint8_t> bytes;
+  uint8_t in[50], read[50];
+  uint8_t next_in = 0, next_out = 0;
+  int errors = 0;
+  for( int round = 0; round < 100; ++round ) {
+    const uint8_t n = 1 + round % 50;
+    for( uint8_t i = 0; i < n; ++i ) in[i] = next_in + i;
+    next_in += bytes.putN(in, n);
+    const uint8_t taken = bytes.takeN(read, 1 + (round * 7) % 50);
+    for( uint8_t i = 0; i < taken; ++i ) errors += ( read[i] != (uint8_t)(next_out + i) );
+    next_out += taken;
+  }
+  CHECK_EQUAL(0, errors);
+  CHECK_EQUAL((uint8_t)(next_in - next_out), bytes.count());
+
+  // an overwriting buffer keeps the newest elements, split at the end
+  OverwritingRingBuffer<8, int> history;
+  CHECK_EQUAL(0, history.spans(&first, &second));
+  for( int i = 0; i < 13; ++i ) history.pushOverwrite(i);
+  CHECK_EQUAL(8, history.count());
+  CHECK_EQUAL(5, history.oldest());
+  CHECK_EQUAL(12, history.newest());
+  CHECK_EQUAL(2, history.spans(&first, &second));
+  CHECK_EQUAL(3, first.length);
+  CHECK_EQUAL(5, first.data[0]);
+  CHECK_EQUAL(5, second.length);
+  CHECK_EQUAL(12, second.data[4]);
+  int expected = 5;
+  for( const int &x : history ) {
+    CHECK_EQUAL(expected, x);
+    expected++;
+  }
+
+  // the overwritten element is only written when one was evicted
+  OverwritingRingBuffer<4, int> small;
+  int overwritten = -1;
+  for( int i = 0; i < 4; ++i ) {
+    CHECK(!small.pushOverwrite(i, &overwritten));
+    CHECK_EQUAL(-1, overwritten);
+  }
+  CHECK(small.pushOverwrite(4, &overwritten));
+  CHECK_EQUAL(0, overwritten);
+  CHECK(small.pushOverwrite(5, &overwritten));
+  CHECK_EQUAL(1, overwritten);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,28 @@
+// Schema uses that must not compile. make -C test compiles this file
+// once as it is, then once with each FAIL_ macro, which must fail.
+#include "messengers/schema.h"
+
+typedef LT::Message<LT::Write_Position, LT::Schema<uint8_t, float> > WritePosition;
+
+int main() {
+  LT::Packet<WritePosition::REQUEST_LENGTH> out;
+  WritePosition::encodeRequest(out, 3, 1.5f);
+  uint8_t id;
+  float position;
+  WritePosition::decodeRequest(LT::PayloadReader(out.data() + 1, out.length() - 1), id, position);
+#if defined(FAIL_DUPLICATE_CODES)
+  // two messages with the same function code
+  typedef LT::MessageSet<WritePosition, LT::WritePositionMessage> Protocol;
+  Protocol::contains(LT::Write_Position);
+#endif
+#if defined(FAIL_TYPE_MISMATCH)
+  // the decoded value is not of the field type
+  int wide_id;
+  WritePosition::decodeRequest(LT::PayloadReader(out.data() + 1, out.length() - 1), wide_id, position);
+#endif
+#if defined(FAIL_ARITY)
+  // a field is missing
+  WritePosition::encodeRequest(out, 3);
+#endif
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Message schemas: packet lengths, byte layout, round trips through
+// encode and decode, length checks, MessageSet visiting, and a request
+// sent and decoded by two BinarySerial messengers.
+#include <Arduino.h>
+#include <vector>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "messengers/binary_serial.h"
+#include "messengers/schema.h"
+
+typedef LT::Message<LT::Write_Position, LT::Schema<uint8_t, float>, LT::Schema<uint8_t, float, int32_t> > WritePosition;
+typedef LT::Message<LT::Read_ADC, LT::Schema<uint8_t>, LT::Schema<uint8_t, uint16_t> > ReadADC;
+typedef LT::MessageSet<WritePosition, ReadADC, LT::AcknowledgeMessage> Protocol;
+
+static_assert(WritePosition::REQUEST_LENGTH == 6, "code, uint8_t and float");
+static_assert(WritePosition::RESPONSE_LENGTH == 10, "code, uint8_t, float and int32_t");
+static_assert(ReadADC::Response::COUNT == 2, "two response fields");
+
+struct Mock : Stream {
+  std::vector<uint8_t> out;
+  size_t write(uint8_t b) override { out.push_back(b); return 1; }
+  size_t write(const uint8_t *b, size_t n) override { out.insert(out.end(), b, b + n); return n; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+// records the fields passed to a visitor
+struct Recorder {
+  std::vector<uint8_t> indices;
+  std::vector<double> values;
+  template <class T>
+  void operator()(const uint8_t index, const T &value) {
+    indices.push_back(index);
+    values.push_back((double)value);
+  }
+};
+
+BinarySerial *receiver;
+int received = 0;
+
+int main() {
+  // request layout: code, then little-endian fields with no padding
+  LT::Packet<WritePosition::REQUEST_LENGTH> request;
+  WritePosition::encodeRequest(request, 3, -101.5f);
+  CHECK(request.ok());
+  CHECK_EQUAL(6, request.length());
+  const uint8_t expected[] = {LT::Write_Position, 3, 0x00, 0x00, 0xCB, 0xC2};
+  CHECK(memcmp(expected, request.data(), sizeof(expected)) == 0);
+
+  uint8_t id = 0;
+  float position = 0;
+  CHECK(WritePosition::decodeRequest(LT::PayloadReader(request.data() + 1, request.length() - 1), id, position));
+  CHECK_EQUAL(3, id);
+  CHECK(position == -101.5f);
+
+  // a packet that is short or long for the schema is rejected
+  CHECK(!WritePosition::decodeRequest(LT::PayloadReader(request.data() + 1, request.length() - 2), id, position));
+  LT::Packet<8> longer;
+  WritePosition::encodeRequest(longer, 3, -101.5f);
+  longer.write((uint8_t)0);
+  CHECK(!WritePosition::decodeRequest(LT::PayloadReader(longer.data() + 1, longer.length() - 1), id, position));
+
+  // a writer that is too small reports it
+  LT::Packet<4> small;
+  WritePosition::encodeRequest(small, 3, -101.5f);
+  CHECK(!small.ok());
+
+  LT::Packet<WritePosition::RESPONSE_LENGTH> response;
+  WritePosition::encodeResponse(response, 7, 2.25f, -40000);
+  int32_t steps = 0;
+  CHECK(WritePosition::decodeResponse(LT::PayloadReader(response.data() + 1, response.length() - 1), id, position, steps));
+  CHECK_EQUAL(7, id);
+  CHECK(position == 2.25f);
+  CHECK_EQUAL(-40000, steps);
+
+  // a MessageSet visits the fields of the message with the packet's code
+  LT::Packet<16> adc;
+  ReadADC::encodeResponse(adc, 2, 1023);
+  Recorder recorder;
+  LT::PayloadReader in(adc.data() + 1, adc.length() - 1);
+  CHECK(Protocol::visitResponse(adc.data()[0], in, recorder));
+  CHECK_EQUAL(2, recorder.values.size());
+  CHECK_EQUAL(1, recorder.indices[1]);
+  CHECK(recorder.values[0] == 2 && recorder.values[1] == 1023);
+
+  LT::PayloadReader unknown(adc.data() + 1, adc.length() - 1);
+  CHECK(!Protocol::visitResponse(LT::Read_Name, unknown, recorder));
+  CHECK(Protocol::contains(LT::Acknowledge));
+  CHECK(!Protocol::contains(LT::Read_Name));
+
+  // sendRequest() frames the packet for a messenger at the other end
+  Mock stream;
+  BinarySerial sender(stream), reader(stream);
+  sender.setTransmitQueue(false);
+  receiver = &reader;
+  reader.setMessageReceivedCallback([](int) {
+    uint8_t id;
+    float position;
+    CHECK_EQUAL(LT::Write_Position, receiver->messageData()[0]);
+    CHECK(LT::WritePositionMessage::decodeRequest(receiver->payload(), id, position));
+    CHECK_EQUAL(4, id);
+    CHECK(position == 12.25f);
+    received++;
+  });
+  CHECK_EQUAL(0, LT::WritePositionMessage::sendRequest(sender, 4, 12.25f));
+  reader.receive(stream.out.data(), stream.out.size());
+  CHECK_EQUAL(1, received);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,94 @@
+// LT_SoftPWM edges on a simulated clock: onStepTimer() is called at the
+// times it asks for and every pin change is traced from the simulated
+// pins.
+#define LT_SIMULATED_PINS
+#include <Arduino.h>
+#include <vector>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/soft_pwm.h"
+
+const uint8_t PINS[6] = {2, 3, 4, 5, 6, 7};
+
+struct Change {
+  uint32_t t;
+  uint8_t channel;
+  uint8_t level;
+};
+
+LT_SoftPWM<6> pwm(1);
+uint32_t now = 0;
+uint32_t calls = 0;
+std::vector<Change> trace;
+
+// call onStepTimer() until the simulated time reaches end
+void run(const uint32_t end) {
+  while( now < end ) {
+    uint8_t before[6];
+    for( uint8_t i = 0; i < 6; ++i ) before[i] = LT::simulatedPins()[PINS[i]];
+    const uint32_t wait = pwm.onStepTimer();
+    calls++;
+    for( uint8_t i = 0; i < 6; ++i ) {
+      const uint8_t level = LT::simulatedPins()[PINS[i]];
+      if( level != before[i] ) trace.push_back(Change{now, i, level});
+    }
+    CHECK(wait >= LT_SOFT_PWM_MIN_US);
+    now += wait;
+  }
+}
+
+// the times that a channel changed to level in [from, to)
+std::vector<uint32_t> changes(const uint8_t channel, const uint8_t level, const uint32_t from, const uint32_t to) {
+  std::vector<uint32_t> times;
+  for( const Change &c : trace ) {
+    if( c.channel == channel && c.level == level && c.t >= from && c.t < to ) times.push_back(c.t);
+  }
+  return times;
+}
+
+int main() {
+  pwm.setPeriod(1000);
+  for( uint8_t i = 0; i < 6; ++i ) CHECK_EQUAL(0, pwm.setChannel(i, PINS[i]));
+  pwm.setValue(0, 64);   // 250 us
+  pwm.setValue(1, 64);   // the same duty: the same edge
+  pwm.setValue(2, 128);  // 501 us
+  pwm.setValue(3, 130);  // 509 us, closer than LT_SOFT_PWM_MIN_US: merged into 501 us
+  pwm.setValue(4, 0);    // off
+  pwm.setValue(5, 300);  // clamped to 255: on
+
+  run(3000);
+  // each period is one start and two edges
+  CHECK_EQUAL(9, calls);
+  for( uint32_t period = 0; period < 3000; period += 1000 ) {
+    for( uint8_t i = 0; i < 4; ++i ) {
+      const std::vector<uint32_t> rises = changes(i, 1, period, period + 1000);
+      const std::vector<uint32_t> falls = changes(i, 0, period, period + 1000);
+      CHECK_EQUAL(1, rises.size());
+      CHECK_EQUAL(1, falls.size());
+      if( rises.size() == 1 ) CHECK_EQUAL(period, rises[0]);
+      if( falls.size() == 1 ) CHECK_EQUAL(period + ((i < 2) ? 250 : 501), falls[0]);
+    }
+  }
+  CHECK_EQUAL(0, changes(4, 1, 0, 3000).size());
+  CHECK_EQUAL(0, LT::simulatedPins()[PINS[4]]);
+  CHECK_EQUAL(1, changes(5, 1, 0, 3000).size());
+  CHECK_EQUAL(0, changes(5, 0, 0, 3000).size());
+  CHECK_EQUAL(1, LT::simulatedPins()[PINS[5]]);
+  CHECK_EQUAL(255, pwm.getValue(5));
+
+  // a change in mid-period waits for the next period
+  run(3100);
+  CHECK_EQUAL(3250, now);
+  pwm.setValue(0, 200);  // 784 us
+  pwm.setValue(5, 0);
+  run(5000);
+  CHECK_EQUAL(3250, changes(0, 0, 3000, 4000)[0]);
+  CHECK_EQUAL(0, changes(5, 0, 3000, 4000).size());
+  CHECK_EQUAL(1, changes(0, 0, 4000, 5000).size());
+  CHECK_EQUAL(4784, changes(0, 0, 4000, 5000)[0]);
+  CHECK_EQUAL(4250, changes(1, 0, 4000, 5000)[0]);
+  CHECK_EQUAL(1, changes(5, 0, 4000, 5000).size());
+  CHECK_EQUAL(4000, changes(5, 0, 4000, 5000)[0]);
+
+  return TEST_RESULT();
+}
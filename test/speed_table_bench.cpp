@@ -0,0 +1,50 @@
+// The cost of a stepper speed change: the float path of setSpeed() against
+// a lookup in an LT_SpeedTable.
+#include <Arduino.h>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "devices/stepper.h"
+
+typedef LT_SpeedTable<4000, 50, 128> PumpSpeeds; // 0.5 RPM per entry
+
+volatile uint32_t sink;
+
+int main() {
+  const uint32_t N = 10000000;
+  const uint16_t resolution = 4000;
+
+  const double float_ns = benchNs([&](uint32_t i) {
+    const float rpm = 0.5f * ((i & 127) | 1);
+    sink = 60000000.0 / ( (float)resolution * rpm );
+  }, N);
+  const double table_ns = benchNs([](uint32_t i) {
+    sink = PumpSpeeds::interval((i & 127) | 1);
+  }, N);
+
+  LT_Stepper motor(1, 2, 5);
+  motor.begin();
+  motor.setResolution(resolution);
+  const double set_speed_ns = benchNs([&](uint32_t i) {
+    motor.setSpeed(0.5f * ((i & 127) | 1));
+  }, N);
+  const double set_index_ns = benchNs([&](uint32_t i) {
+    motor.setSpeedIndex<PumpSpeeds>((i & 127) | 1, true);
+  }, N);
+
+  // the table should give the float interval, rounded down
+  uint32_t max_difference = 0;
+  for( uint16_t i = 1; i < PumpSpeeds::size(); ++i ) {
+    const uint32_t computed = 60000000.0 / ( (float)resolution * 0.5f * i );
+    const uint32_t table = PumpSpeeds::interval(i);
+    const uint32_t difference = (computed > table) ? computed - table : table - computed;
+    if( difference > max_difference ) max_difference = difference;
+  }
+
+  printf("speed change, ns per call\n");
+  printf("  interval, float division   %6.2f\n", float_ns);
+  printf("  interval, table lookup     %6.2f\n", table_ns);
+  printf("  setSpeed(rpm)              %6.2f\n", set_speed_ns);
+  printf("  setSpeedIndex<Table>(i)    %6.2f\n", set_index_ns);
+  printf("largest difference between the table and the float interval: %u us\n", max_difference);
+  return 0;
+}
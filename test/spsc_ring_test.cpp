@@ -0,0 +1,111 @@
+// SpscRing: single thread behaviour, and a stress test with the producer
+// and consumer on two threads, mixing single and bulk calls.
+#include <Arduino.h>
+#include <thread>
+#include "test.h"
+#include "utilities/spsc_ring.h"
+
+// the second word is derived from the first, so a torn element is detected
+struct Sample {
+  uint32_t sequence;
+  uint32_t check;
+};
+
+Sample sample(const uint32_t i) {
+  Sample s = {i, (uint32_t)(~i * 2654435761UL)};
+  return s;
+}
+
+void singleThread() {
+  SpscRing<4, uint16_t> ring;
+  uint16_t v = 0;
+  CHECK(ring.isEmpty());
+  CHECK_EQUAL(-1, ring.take(&v));
+  CHECK_EQUAL(-1, ring.peek(&v));
+  for( uint16_t i = 0; i < 4; ++i ) {
+    CHECK_EQUAL(0, ring.put(i));
+  }
+  CHECK(ring.isFull());
+  CHECK_EQUAL(-1, ring.put(4));
+  CHECK_EQUAL(0, ring.peek(&v));
+  CHECK_EQUAL(0, v);
+  CHECK_EQUAL(0, ring.take(&v));
+  CHECK_EQUAL(0, v);
+  CHECK_EQUAL(3, ring.count());
+
+  // bulk calls are cut to the room and to the elements there are, across the wrap
+  const uint16_t in[3] = {10, 11, 12};
+  CHECK_EQUAL(1, ring.putN(in, 3));
+  uint16_t out[8];
+  CHECK_EQUAL(4, ring.takeN(out, 8));
+  CHECK_EQUAL(1, out[0]);
+  CHECK_EQUAL(3, out[2]);
+  CHECK_EQUAL(10, out[3]);
+  CHECK_EQUAL(3, ring.putN(in, 3));
+  ring.clear();
+  CHECK(ring.isEmpty());
+  CHECK_EQUAL(4, ring.available());
+}
+
+void twoThreads() {
+  static SpscRing<64, Sample> ring;
+  const uint32_t N = 2000000;
+  uint32_t errors = 0;
+
+  std::thread producer([&]() {
+    Sample buffer[7];
+    uint32_t i = 0;
+    while( i < N ) {
+      if( i % 3 == 0 ) {
+        uint16_t n = 0;
+        while( n < 7 && i + n < N ) {
+          buffer[n] = sample(i + n);
+          ++n;
+        }
+        const uint16_t put = ring.putN(buffer, n);
+        i += put;
+        if( put == 0 ) std::this_thread::yield();
+      }
+      else if( ring.put(sample(i)) == 0 ) {
+        ++i;
+      }
+      else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::thread consumer([&]() {
+    Sample buffer[5];
+    uint32_t expected = 0;
+    while( expected < N ) {
+      uint16_t n = 0;
+      if( expected % 2 ) {
+        n = ring.takeN(buffer, 5);
+      }
+      else if( ring.take(&buffer[0]) == 0 ) {
+        n = 1;
+      }
+      if( n == 0 ) {
+        std::this_thread::yield();
+      }
+      for( uint16_t k = 0; k < n; ++k ) {
+        const Sample s = sample(expected++);
+        if( buffer[k].sequence != s.sequence || buffer[k].check != s.check ) {
+          errors++;
+        }
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+  CHECK_EQUAL(0, errors);
+  CHECK(ring.isEmpty());
+}
+
+int main() {
+  singleThread();
+  twoThreads();
+  return TEST_RESULT();
+}
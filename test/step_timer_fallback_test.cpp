@@ -0,0 +1,24 @@
+// Without a timer backend, interrupt driven mode is refused and the motor
+// keeps stepping from update().
+#define LT_SIMULATED_PINS
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/stepper.h"
+
+LT_BasicStepper<FastPin<2>, FastPin<5> > motor(1);
+
+int main() {
+  CHECK(!LT_StepTimer::available());
+  motor.begin();
+  CHECK(!motor.setInterruptDriven(true));
+
+  motor.rotate(10, 300);
+  for( LT_current_time_us = 0; LT_current_time_us < 20000; LT_current_time_us += 10 ) {
+    motor.update();
+  }
+  CHECK_EQUAL(10, motor.currentPosition());
+  CHECK(!LT_StepTimer::isActive());
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,93 @@
+// Interrupt driven stepping on the simulated step timer: the time of every
+// pulse edge, and the fallback to update() without a timer backend.
+#define LT_SIMULATED_PINS
+#define LT_SIMULATED_TIMER
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "devices/stepper.h"
+
+typedef LT_BasicStepper<FastPin<2>, FastPin<5> > Motor;
+Motor motor(1);
+
+// the timer owner: steps the motor and records the time of each edge
+struct Probe {
+  static const uint16_t N = 64;
+  uint32_t rises[N];
+  uint32_t falls[N];
+  uint16_t n_rises;
+  uint16_t n_falls;
+
+  void clear() { n_rises = n_falls = 0; }
+
+  uint32_t onStepTimer() {
+    const uint8_t before = FastPin<2>::read();
+    const uint32_t next = motor.onStepTimer();
+    const uint8_t after = FastPin<2>::read();
+    if( !before && after && n_rises < N ) rises[n_rises++] = LT_StepTimer::now();
+    if( before && !after && n_falls < N ) falls[n_falls++] = LT_StepTimer::now();
+    return next;
+  }
+} probe;
+LT_STEP_TIMER_ISR(probe);
+
+// run the loop every 50 us of simulated time until the timer stops
+void run() {
+  const uint32_t t_end = LT_StepTimer::now() + 10000000UL;
+  do {
+    LT_current_time_us = LT_StepTimer::now();
+    motor.update();
+    LT_StepTimer::advance(50);
+  } while( (LT_StepTimer::isActive() || motor.distanceToGo() != 0) && LT_StepTimer::now() < t_end );
+}
+
+// n pulses with rising edges interval us apart, each high for width us
+void checkPulses(const uint16_t n, const uint32_t interval, const uint32_t width) {
+  CHECK_EQUAL(n, probe.n_rises);
+  CHECK_EQUAL(n, probe.n_falls);
+  for( uint16_t i = 0; i < probe.n_rises && i < probe.n_falls; ++i ) {
+    CHECK_EQUAL(width, probe.falls[i] - probe.rises[i]);
+    if( i > 0 ) {
+      CHECK_EQUAL(interval, probe.rises[i] - probe.rises[i - 1]);
+    }
+  }
+}
+
+int main() {
+  CHECK(LT_StepTimer::available());
+  motor.begin();
+  CHECK(motor.setInterruptDriven(true));
+
+  // 300 rpm at 200 steps/rev is a step every 1000 us
+  probe.clear();
+  motor.rotate(20, 300);
+  run();
+  checkPulses(20, 1000, 30);
+  CHECK_EQUAL(20, motor.currentPosition());
+  CHECK(!LT_StepTimer::isActive());
+
+  // a pulse shorter than the timer can time is lengthened to LT_STEP_TIMER_MIN_US
+  probe.clear();
+  motor.setPulseWidth(2);
+  motor.rotate(-5, 300);
+  run();
+  CHECK_EQUAL(5, probe.n_rises);
+  for( uint16_t i = 0; i < probe.n_rises; ++i ) {
+    CHECK_EQUAL(LT_STEP_TIMER_MIN_US, probe.falls[i] - probe.rises[i]);
+  }
+  CHECK_EQUAL(15, motor.currentPosition());
+
+  // intervals longer than the 16 bit timer are split without losing time
+  probe.clear();
+  motor.setPulseWidth(30);
+  motor.rotate(3, 3); // 100000 us per step
+  run();
+  checkPulses(3, 100000, 30);
+  CHECK_EQUAL(18, motor.currentPosition());
+
+  // turning the timer off goes back to update()
+  CHECK(!motor.setInterruptDriven(false));
+  CHECK(!LT_StepTimer::isActive());
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,43 @@
+// The cost of LT_TimerService::update() per tick as the number of running
+// timers grows. Short periods expire from level 0. Long periods spread the
+// timers over the upper levels, so most of the work is cascading.
+#include <Arduino.h>
+#include "bench.h"
+uint32_t LT_current_time_us;
+#include "utilities/timer_service.h"
+
+uint32_t expiries;
+void onExpire(int) { expiries++; }
+
+template <uint8_t N>
+void run(const char *name, const uint32_t max_period) {
+  LT_TimerService<N> timers(1, 1);
+  LT_current_time_us = 0;
+  timers.begin();
+  uint32_t seed = 1;
+  for( uint8_t i = 0; i < N; ++i ) {
+    seed = seed * 1103515245 + 12345;
+    const uint32_t period = 1 + (seed >> 8) % max_period;
+    timers.start(timers.create(onExpire), period, period);
+  }
+  expiries = 0;
+  const uint32_t ticks = 4000000;
+  const double tick_ns = benchNs([&](uint32_t) {
+    LT_current_time_us++;
+    timers.update();
+  }, ticks);
+  printf("  %-6s %4u %10.1f %10u %12.1f\n", name, N, tick_ns, expiries,
+    expiries ? tick_ns * ticks / expiries : 0.0);
+}
+
+int main() {
+  printf("LT_TimerService, 4M ticks of 1 us\n");
+  printf("  periods timers  ns/tick   expiries  ns/expiry\n");
+  run<10>("short", 32);
+  run<50>("short", 32);
+  run<250>("short", 32);
+  run<10>("long", 1UL << 18);
+  run<50>("long", 1UL << 18);
+  run<250>("long", 1UL << 18);
+  return 0;
+}
@@ -0,0 +1,120 @@
+// LT_TimerService on a simulated clock with a 1 us tick: timers at every
+// level of the wheel and past its range never expire early, are late by
+// no more than the time between updates, and periodic timers do not drift.
+#include <Arduino.h>
+#include "test.h"
+uint32_t LT_current_time_us;
+#include "utilities/timer_service.h"
+
+const uint8_t N = 64;
+typedef LT_TimerService<N> Timers;
+Timers timers(1, 1);
+
+uint32_t due[N];     ///< the time each timer should expire
+uint32_t period[N];  ///< the period of each timer, 0 for single shot
+uint32_t fired[N];   ///< the number of expiries of each timer
+uint32_t worst_late = 0;
+int early = 0;
+
+void onExpire(int handle) {
+  const uint32_t late = LT_current_time_us - due[handle];
+  if( (int32_t)late < 0 ) {
+    early++;
+  }
+  else if( late > worst_late ) {
+    worst_late = late;
+  }
+  fired[handle]++;
+  due[handle] += period[handle];
+}
+
+uint32_t seed = 1;
+uint32_t randomTo(const uint32_t n) {
+  seed = seed * 1103515245 + 12345;
+  return ((seed >> 8) ^ (seed << 12)) % n;
+}
+
+// a delay in one of the ranges of the wheel levels, or past the wheel
+uint32_t randomDelay() {
+  static const uint32_t RANGES[] = {32, 1UL << 10, 1UL << 15, 1UL << 20, 1UL << 22};
+  return 1 + randomTo(RANGES[randomTo(5)]);
+}
+
+// start half the timers as single shot and half as periodic
+void startAll() {
+  for( uint8_t i = 0; i < N; ++i ) {
+    const uint32_t delay = randomDelay();
+    period[i] = (i & 1) ? 0 : randomDelay();
+    due[i] = LT_current_time_us + delay;
+    fired[i] = 0;
+    CHECK(timers.start(i, delay, period[i]));
+  }
+}
+
+// run until end, updating every `step` us or at random steps up to `step`
+void runTo(const uint32_t end, const uint32_t step, const bool random_step) {
+  while( LT_current_time_us < end ) {
+    LT_current_time_us += random_step ? 1 + randomTo(step) : step;
+    timers.update();
+  }
+}
+
+int main() {
+  timers.begin();
+  for( uint8_t i = 0; i < N; ++i ) CHECK_EQUAL(i, timers.create(onExpire));
+  CHECK_EQUAL(Timers::NO_TIMER, timers.create(onExpire));
+
+  // updated every tick, each timer expires on its tick
+  startAll();
+  const uint32_t end = LT_current_time_us + (1UL << 23);
+  runTo(end, 1, false);
+  CHECK_EQUAL(0, early);
+  CHECK_EQUAL(0, worst_late);
+  for( uint8_t i = 0; i < N; ++i ) {
+    // single shots fired once, periodic timers once per period
+    if( period[i] == 0 ) {
+      CHECK_EQUAL(1, fired[i]);
+      CHECK(!timers.isActive(i));
+    }
+    else {
+      CHECK(fired[i] >= 1);
+      CHECK(due[i] > end);
+      CHECK(due[i] - period[i] <= end);
+    }
+  }
+
+  // updated at random intervals of up to 100 us, a timer is late by less
+  // than the interval
+  startAll();
+  runTo(LT_current_time_us + (1UL << 23), 100, true);
+  CHECK_EQUAL(0, early);
+  CHECK(worst_late < 100);
+  for( uint8_t i = 0; i < N; i += 2 ) CHECK(fired[i] >= 1);
+
+  // a timer restarted from its own callback and one cancelled by it
+  for( uint8_t i = 0; i < N; ++i ) timers.cancel(i);
+  CHECK_EQUAL(0, timers.activeCount());
+  static uint32_t restarts = 0;
+  timers.setCallback(0, [](int handle) {
+    restarts++;
+    timers.cancel(1);
+    if( restarts < 5 ) timers.start(handle, 40);
+  });
+  const uint32_t t_start = LT_current_time_us;
+  const uint32_t fired_1 = fired[1];
+  timers.start(0, 40);
+  timers.start(1, 70);
+  CHECK_EQUAL(40, timers.remaining(0));
+  runTo(t_start + 1000, 1, false);
+  CHECK_EQUAL(5, restarts);
+  CHECK_EQUAL(fired_1, fired[1]); // cancelled before it expired
+  CHECK(!timers.isActive(1));
+  CHECK_EQUAL(0, timers.activeCount());
+
+  timers.destroy(3);
+  CHECK_EQUAL(1, timers.available());
+  CHECK(!timers.start(3, 10));
+  CHECK_EQUAL(3, timers.create(onExpire));
+
+  return TEST_RESULT();
+}